@@ -14,7 +14,7 @@ protected:
  
 public:
 
-   cube( hwlib::window & w, const hwlib::xy & midpoint, int radius ):
+   cube( window_paged & w, const hwlib::xy & midpoint, int radius ):
       drawable( w, 
          midpoint - hwlib::xy( radius, radius ), 
          hwlib::xy( radius, radius ) * 2 ),
@@ -22,12 +22,8 @@ public:
    {}
    
    void draw() override {
-    for(int i = location.x; i < location.x + size.x; i++){
-        for(int j = location.y; j < location.y + size.y; j++){
-            w.write(hwlib::xy(i,j));
-        }
-    }
-}
+      w.fill_rect( location, location + size - hwlib::xy( 1, 1 ) );
+   }
 };
 
 #endif
@@ -8,26 +8,31 @@
 #define DRAWABLE_HPP
 
 #include <hwlib.hpp>
+#include "window_paged.hpp"
+#include <algorithm>
 
 class drawable {
 protected:
 
-    hwlib::window & w;
+    window_paged & w;
     hwlib::xy location;
+    hwlib::xy previous_location;
     hwlib::xy size;
     hwlib::xy moving_cube_angle = {1,1};
    
 public:
 
-    drawable( hwlib::window & w, const hwlib::xy & location, const hwlib::xy & size ):
+    drawable( window_paged & w, const hwlib::xy & location, const hwlib::xy & size ):
       w( w ),
       location( location ),
+      previous_location( location ),
       size( size )
    {}  
 
-   drawable( hwlib::window & w, const hwlib::xy & location, const hwlib::xy & size, const hwlib::xy moving_cube_angle ):
+   drawable( window_paged & w, const hwlib::xy & location, const hwlib::xy & size, const hwlib::xy moving_cube_angle ):
       w( w ),
       location( location ),
+      previous_location( location ),
       size( size ),
       moving_cube_angle(moving_cube_angle)
    {}      
@@ -35,8 +40,34 @@ public:
    virtual void draw() = 0;
    virtual void update(){}
    bool overlaps( const drawable & other );   
+   int time_of_impact( const drawable & other ) const;
    virtual void interact( drawable & other ){}
    
+   /// \brief
+   /// Remembers where the drawable is before update() moves it, time_of_impact() sweeps from there.
+   void begin_step(){
+      previous_location = location;
+   }
+   
+   /// \brief
+   /// Returns the box that contains the drawable at the start and at the end of the step.
+   void swept_bounds( hwlib::xy & min, hwlib::xy & max ) const {
+      min = hwlib::xy( 
+         std::min( location.x, previous_location.x ), 
+         std::min( location.y, previous_location.y ) 
+      );
+      max = hwlib::xy( 
+         std::max( location.x, previous_location.x ), 
+         std::max( location.y, previous_location.y ) 
+      ) + size;
+   }
+   
+   /// \brief
+   /// Returns the top left corner of the drawable.
+   hwlib::xy get_location() const {
+      return location;
+   }
+   
    hwlib::ostream & print( hwlib::ostream & out ) const {
       return out << location << " " << ( location + size );
    }
@@ -46,15 +77,15 @@ public:
     }
 };
 
-hwlib::ostream & operator<<( hwlib::ostream & lhs, const drawable & rhs ){
+inline hwlib::ostream & operator<<( hwlib::ostream & lhs, const drawable & rhs ){
    return rhs.print( lhs );
 }
 
-bool within( int x, int a, int b ){
+inline bool within( int x, int a, int b ){
    return ( x >= a ) && ( x <= b );
 }
 
-bool drawable::overlaps( const drawable & other ){
+inline bool drawable::overlaps( const drawable & other ){
    
    bool x_overlap = within( 
       location.x, 
@@ -79,5 +110,45 @@ bool drawable::overlaps( const drawable & other ){
    return x_overlap && y_overlap;
 }
 
+// Computes when box a, moving v pixels, starts and stops overlapping box b on one axis, as a fraction of 256 of the step.
+inline bool sweep_axis( int a, int a_size, int b, int b_size, int v, int & entry, int & exit ){
+   if( v == 0 ){
+      if( a > b + b_size || b > a + a_size ){
+         return false;
+      }
+      entry = -0x10000;
+      exit = 0x10000;
+   } else if( v > 0 ){
+      entry = ( b - ( a + a_size ) ) * 256 / v;
+      exit = ( ( b + b_size ) - a ) * 256 / v;
+   } else {
+      entry = ( ( b + b_size ) - a ) * 256 / v;
+      exit = ( b - ( a + a_size ) ) * 256 / v;
+   }
+   return true;
+}
+
+/// \brief
+/// Returns when this drawable hits other during the last step, as a fraction of 256 of the step, or -1 when it doesn't.
+/// \details
+/// Both drawables are swept from their previous_location to their location, so a fast ball can't jump over a thin paddle.
+/// Drawables that only touch and move apart don't hit.
+inline int drawable::time_of_impact( const drawable & other ) const {
+   hwlib::xy motion = ( location - previous_location ) - ( other.location - other.previous_location );
+   int entry_x, exit_x, entry_y, exit_y;
+   if( 
+      !sweep_axis( previous_location.x, size.x, other.previous_location.x, other.size.x, motion.x, entry_x, exit_x ) ||
+      !sweep_axis( previous_location.y, size.y, other.previous_location.y, other.size.y, motion.y, entry_y, exit_y )
+   ){
+      return -1;
+   }
+   int entry = std::max( entry_x, entry_y );
+   int exit = std::min( exit_x, exit_y );
+   if( entry > exit || exit <= 0 || entry > 256 ){
+      return -1;
+   }
+   return std::max( entry, 0 );
+}
+
 
 #endif
@@ -0,0 +1,216 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef ENTITY_STORE_HPP
+#define ENTITY_STORE_HPP
+
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include "drawable.hpp"
+
+/// \brief
+/// Keeps every drawable of the game in arrays of their own type and updates, collides and draws them without virtual calls.
+/// \details
+/// Example: entity_store< std::array< line, 4 >, std::array< moving_cube, 1 >, std::array< player, 2 > > entities( oled.size, walls, balls, paddles );
+///
+/// Statics is one std::array of drawables that never move and never interact (the walls).
+/// Dynamics are std::arrays of drawables that are updated every step (the ball and the paddles).
+/// Because the type of every array is known at compile time, the loops call draw, update and interact with a qualified name (d.T::draw()), so there is no vtable lookup and the compiler can inline them.
+///
+/// Collisions use a grid of columns x rows cells, every cell has a bit mask of the static and the dynamic drawables whose box touches it.
+/// The boxes the dynamic drawables sweep over a step are gathered in 2 plain arrays first, so binning them is a tight loop over those arrays.
+/// A dynamic drawable only interacts with the drawables in the cells its own swept box touches.
+/// Of those it interacts with the one it hits first according to time_of_impact(), a bounce changes its path so after that its box is swept again and the rest of the path is tested against all of them.
+/// That way a ball that hits a wall and a paddle in one step bounces off the one it really reaches first.
+///
+/// Both kinds are limited to 32 drawables, one bit each.
+template< typename Statics, typename... Dynamics >
+class entity_store {
+private:
+
+   static constexpr int columns = 8;
+   static constexpr int rows = 4;
+   
+   // A ball in a corner bounces off 2 drawables in one step, more than this per step is a drawable stuck between 2 others.
+   static constexpr int max_bounces = 4;
+   static constexpr size_t static_count = std::tuple_size< Statics >::value;
+   static constexpr size_t dynamic_count = ( std::tuple_size< Dynamics >::value + ... );
+
+   static_assert( static_count <= 32 && dynamic_count <= 32, "the cell masks have one bit per drawable" );
+
+   Statics statics;
+   std::tuple< Dynamics... > dynamics;
+   
+   std::array< hwlib::xy, dynamic_count > swept_min;
+   std::array< hwlib::xy, dynamic_count > swept_max;
+   
+   std::array< uint32_t, columns * rows > static_cells = {};
+   std::array< uint32_t, columns * rows > dynamic_cells = {};
+   
+   int cell_width;
+   int cell_height;
+   
+   int column( int x ) const {
+      return std::min( std::max( x / cell_width, 0 ), columns - 1 );
+   }
+   
+   int row( int y ) const {
+      return std::min( std::max( y / cell_height, 0 ), rows - 1 );
+   }
+   
+   // Sets bit in every cell the box touches.
+   void mark( std::array< uint32_t, columns * rows > & cells, const hwlib::xy & min, const hwlib::xy & max, uint32_t bit ){
+      for( int r = row( min.y ); r <= row( max.y ); r++ ){
+         for( int c = column( min.x ); c <= column( max.x ); c++ ){
+            cells[ r * columns + c ] |= bit;
+         }
+      }
+   }
+   
+   // Returns the masks of every cell the box touches ORed together.
+   uint32_t collect( const std::array< uint32_t, columns * rows > & cells, const hwlib::xy & min, const hwlib::xy & max ) const {
+      uint32_t mask = 0;
+      for( int r = row( min.y ); r <= row( max.y ); r++ ){
+         for( int c = column( min.x ); c <= column( max.x ); c++ ){
+            mask |= cells[ r * columns + c ];
+         }
+      }
+      return mask;
+   }
+   
+   // Calls f( drawable, index ) for every dynamic drawable, the index runs over all arrays.
+   template< typename F >
+   void for_each_dynamic( F && f ){
+      size_t index = 0;
+      std::apply( [ & ]( auto & ... arrays ){
+         ( ..., [ & ]( auto & array ){
+            for( auto & d : array ){
+               f( d, index++ );
+            }
+         }( arrays ) );
+      }, dynamics );
+   }
+
+public:
+
+   entity_store( const hwlib::xy & world_size, const Statics & statics, const Dynamics & ... dynamics ):
+      statics( statics ),
+      dynamics( dynamics... ),
+      cell_width( ( world_size.x + columns - 1 ) / columns ),
+      cell_height( ( world_size.y + rows - 1 ) / rows )
+   {
+      for( size_t i = 0; i < static_count; i++ ){
+         hwlib::xy min, max;
+         this->statics[ i ].swept_bounds( min, max );
+         mark( static_cells, min, max, 1UL << i );
+      }
+   }
+   
+   /// \brief
+   /// Returns the array of the K-th kind of dynamic drawables.
+   template< size_t K >
+   auto & dynamic(){
+      return std::get< K >( dynamics );
+   }
+   
+   /// \brief
+   /// Does one step: updates every dynamic drawable and lets it interact with the drawables that are near its path.
+   /// \details
+   /// Same as move() followed by collide(), those are separate so the cost of each can be measured.
+   void step(){
+      move();
+      collide();
+   }
+   
+   /// \brief
+   /// Updates every dynamic drawable and gathers the box it swept over.
+   void move(){
+      for_each_dynamic( [ & ]( auto & d, size_t i ){
+         using T = std::decay_t< decltype( d ) >;
+         d.begin_step();
+         d.T::update();
+         d.swept_bounds( swept_min[ i ], swept_max[ i ] );
+      } );
+   }
+   
+   /// \brief
+   /// Lets every dynamic drawable interact with the drawables near the box it swept over in the last move().
+   /// \details
+   /// The drawable it hits first is handled first, after that its box is swept again from where interact() left it.
+   /// This repeats until nothing is hit anymore, interact() doesn't change the path or max_bounces is reached.
+   /// The drawable that was just handled is skipped in the next round, the drawable touches it and moves away from it.
+   void collide(){
+      dynamic_cells.fill( 0 );
+      for( size_t i = 0; i < dynamic_count; i++ ){
+         mark( dynamic_cells, swept_min[ i ], swept_max[ i ], 1UL << i );
+      }
+      
+      for_each_dynamic( [ & ]( auto & d, size_t i ){
+         using T = std::decay_t< decltype( d ) >;
+         const drawable * last = nullptr;
+         for( int bounce = 0; bounce < max_bounces; bounce++ ){
+            drawable * first = nullptr;
+            int earliest = 0;
+            auto consider = [ & ]( drawable & other ){
+               if( & other == last ){
+                  return;
+               }
+               int impact = d.time_of_impact( other );
+               if( impact >= 0 && ( first == nullptr || impact < earliest ) ){
+                  first = & other;
+                  earliest = impact;
+               }
+            };
+            
+            uint32_t near_static = collect( static_cells, swept_min[ i ], swept_max[ i ] );
+            uint32_t near_dynamic = collect( dynamic_cells, swept_min[ i ], swept_max[ i ] ) & ~( 1UL << i );
+            for( size_t j = 0; near_static != 0; j++, near_static >>= 1 ){
+               if( near_static & 1 ){
+                  consider( statics[ j ] );
+               }
+            }
+            if( near_dynamic != 0 ){
+               for_each_dynamic( [ & ]( auto & other, size_t j ){
+                  if( ( near_dynamic >> j ) & 1 ){
+                     consider( other );
+                  }
+               } );
+            }
+            if( first == nullptr ){
+               break;
+            }
+            
+            hwlib::xy old_min = swept_min[ i ];
+            hwlib::xy old_max = swept_max[ i ];
+            d.T::interact( * first );
+            d.swept_bounds( swept_min[ i ], swept_max[ i ] );
+            if( 
+               swept_min[ i ].x == old_min.x && swept_min[ i ].y == old_min.y && 
+               swept_max[ i ].x == old_max.x && swept_max[ i ].y == old_max.y 
+            ){
+               break;
+            }
+            mark( dynamic_cells, swept_min[ i ], swept_max[ i ], 1UL << i );
+            last = first;
+         }
+      } );
+   }
+   
+   /// \brief
+   /// Draws every static and every dynamic drawable.
+   void draw(){
+      for( auto & s : statics ){
+         using T = std::decay_t< decltype( s ) >;
+         s.T::draw();
+      }
+      for_each_dynamic( [ & ]( auto & d, size_t ){
+         using T = std::decay_t< decltype( d ) >;
+         d.T::draw();
+      } );
+   }
+};
+
+#endif
@@ -0,0 +1,165 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FRAME_SCHEDULER_HPP
+#define FRAME_SCHEDULER_HPP
+
+#include "hwlib.hpp"
+
+/// \brief
+/// Fixed timestep game loop timing on hwlib::now_us(), or on another clock.
+/// \details
+/// Example: frame_scheduler scheduler( 40000, 40000 );
+///
+/// The clock and the function that sleeps can be given, so a test can run the scheduler on a clock that only moves when it moves it.
+///
+/// The game is updated in steps of a fixed amount of simulated time, and drawn once per frame.
+/// steps() returns how many update steps are due since the last call, so when a frame takes too long the next frame does more steps and the game keeps the same speed.
+/// To keep one slow frame from snowballing the amount of steps per frame is capped, the steps above that are dropped.
+/// wait() sleeps only the time that is left until the deadline of the frame, instead of a fixed time on top of the work.
+///
+/// Typical loop:
+///
+///     scheduler.start();
+///     for(;;){
+///        for( int n = scheduler.steps(); n > 0; n-- ){ update(); }
+///        draw();
+///        scheduler.wait();
+///     }
+class frame_scheduler {
+private:
+
+   uint_fast64_t step_us;
+   uint_fast64_t frame_us;
+   int max_steps;
+   uint_fast64_t (*clock)();
+   void (*sleep)( int_fast32_t );
+   
+   uint_fast64_t simulated = 0;
+   uint_fast64_t frame_start = 0;
+   
+   uint32_t frames = 0;
+   uint32_t overruns = 0;
+   uint32_t dropped_steps = 0;
+   uint32_t last_frame_us = 0;
+   uint32_t max_frame_us = 0;
+   uint_fast64_t total_frame_us = 0;
+
+public:
+
+   frame_scheduler( 
+      const uint32_t & step_us, const uint32_t & frame_us, const int & max_steps = 4, 
+      uint_fast64_t (*clock)() = hwlib::now_us, void (*sleep)( int_fast32_t ) = hwlib::wait_us 
+   ):
+      step_us( step_us ),
+      frame_us( frame_us ),
+      max_steps( max_steps ),
+      clock( clock ),
+      sleep( sleep )
+   {}
+   
+   /// \brief
+   /// Starts the simulated time and the first frame now.
+   void start(){
+      simulated = clock();
+      frame_start = simulated;
+   }
+   
+   /// \brief
+   /// Returns the amount of update steps that are due, at most max_steps.
+   int steps(){
+      uint_fast64_t now = clock();
+      int due = ( now - simulated ) / step_us;
+      simulated += due * step_us;
+      if( due > max_steps ){
+         dropped_steps += due - max_steps;
+         due = max_steps;
+      }
+      return due;
+   }
+   
+   /// \brief
+   /// Sleeps until the deadline of this frame and starts the next one.
+   /// \details
+   /// When the deadline has already passed the frame is counted as an overrun and the next frame starts right away.
+   void wait(){
+      uint_fast64_t now = clock();
+      last_frame_us = now - frame_start;
+      total_frame_us += last_frame_us;
+      if( last_frame_us > max_frame_us ){
+         max_frame_us = last_frame_us;
+      }
+      frames++;
+      
+      uint_fast64_t deadline = frame_start + frame_us;
+      if( now < deadline ){
+         sleep( deadline - now );
+         frame_start = deadline;
+      } else {
+         overruns++;
+         frame_start = now;
+      }
+   }
+   
+   /// \brief
+   /// Returns the amount of frames since the last reset_statistics().
+   uint32_t get_frames() const {
+      return frames;
+   }
+   
+   /// \brief
+   /// Returns the amount of frames that took longer than the frame period.
+   uint32_t get_overruns() const {
+      return overruns;
+   }
+   
+   /// \brief
+   /// Returns the amount of update steps that were dropped because a frame needed more than max_steps.
+   uint32_t get_dropped_steps() const {
+      return dropped_steps;
+   }
+   
+   /// \brief
+   /// Returns the time the last frame took from its start until wait() was called, in us.
+   uint32_t get_last_frame_us() const {
+      return last_frame_us;
+   }
+   
+   /// \brief
+   /// Returns the longest frame time, in us.
+   uint32_t get_max_frame_us() const {
+      return max_frame_us;
+   }
+   
+   /// \brief
+   /// Returns the average frame time, in us.
+   uint32_t get_average_frame_us() const {
+      return frames == 0 ? 0 : total_frame_us / frames;
+   }
+   
+   void reset_statistics(){
+      frames = 0;
+      overruns = 0;
+      dropped_steps = 0;
+      last_frame_us = 0;
+      max_frame_us = 0;
+      total_frame_us = 0;
+   }
+   
+   hwlib::ostream & print( hwlib::ostream & out ) const {
+      return out 
+         << "frames " << frames
+         << " avg " << get_average_frame_us() << "us"
+         << " max " << max_frame_us << "us"
+         << " overruns " << overruns
+         << " dropped steps " << dropped_steps;
+   }
+};
+
+inline hwlib::ostream & operator<<( hwlib::ostream & lhs, const frame_scheduler & rhs ){
+   return rhs.print( lhs );
+}
+
+#endif
@@ -0,0 +1,122 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef GLCD_OLED_PAGED_HPP
+#define GLCD_OLED_PAGED_HPP
+
+#include "hwlib.hpp"
+#include "i2c_backend.hpp"
+#include "window_paged.hpp"
+#include "profiling.hpp"
+
+/// \brief
+/// 128x64 SSD1306 OLED on an i2c_backend that only sends what changed.
+/// \details
+/// Example: glcd_oled_paged oled( backend, 0x3c );
+///
+/// Drawing is done in memory like with hwlib::glcd_oled, so the game can still clear and redraw everything every frame.
+/// The difference is in flush: the OLED keeps a copy of what it sent last time and compares every page with it.
+/// For every page that changed only the columns from the first to the last changed byte are sent, pages that didn't change aren't sent at all.
+/// When only the ball and the paddles move that is a few short column ranges instead of the full 1024 bytes.
+///
+/// Because the OLED uses an i2c_backend it can share the bus with the sensors on any backend, including i2c_backend_twi.
+class glcd_oled_paged : public window_paged {
+private:
+
+   static constexpr int width = 128;
+   static constexpr int height = 64;
+
+   i2c_backend & bus;
+   uint8_t address;
+   uint8_t pixels[ width * height / 8 ];
+   uint8_t sent[ width * height / 8 ];
+   bool sent_valid = false;
+   uint32_t flushed_bytes = 0;
+   
+   void send_page( int p, int first, int last ){
+      const uint8_t commands[] = {
+         0x00,                  // the rest of the transaction are commands
+         0x21, (uint8_t) first, (uint8_t) last,   // column range
+         0x22, (uint8_t) p, (uint8_t) p           // page range
+      };
+      bus.write( address, commands, sizeof( commands ) );
+      IPASS_PROFILE_I2C( sizeof( commands ) );
+      
+      uint8_t data[ width + 1 ];
+      data[ 0 ] = 0x40;         // the rest of the transaction is display data
+      int n = 0;
+      for( int x = first; x <= last; x++ ){
+         data[ ++n ] = pixels[ p * width + x ];
+         sent[ p * width + x ] = pixels[ p * width + x ];
+      }
+      bus.write( address, data, n + 1 );
+      IPASS_PROFILE_I2C( n + 1 );
+      flushed_bytes += sizeof( commands ) + n + 1;
+   }
+   
+public:
+
+   glcd_oled_paged( i2c_backend & bus, uint8_t address = 0x3c ):
+      window_paged( hwlib::xy( width, height ), pixels ),
+      bus( bus ),
+      address( address )
+   {
+      const uint8_t init[] = {
+         0x00,                  // the rest of the transaction are commands
+         0xAE,                  // display off
+         0xD5, 0x80,            // clock divider
+         0xA8, 0x3F,            // multiplex of 64 rows
+         0xD3, 0x00,            // no display offset
+         0x40,                  // start at line 0
+         0x8D, 0x14,            // charge pump on
+         0x20, 0x00,            // horizontal addressing
+         0xA1,                  // column 127 is segment 0
+         0xC8,                  // scan the rows from the bottom
+         0xDA, 0x12,            // alternative row layout
+         0x81, 0xCF,            // contrast
+         0xD9, 0xF1,            // pre-charge period
+         0xDB, 0x40,            // VCOMH level
+         0xA4,                  // show the display RAM
+         0xA6,                  // not inverted
+         0xAF                   // display on
+      };
+      bus.write( address, init, sizeof( init ) );
+      IPASS_PROFILE_I2C( sizeof( init ) );
+      clear();
+   }
+   
+   /// \brief
+   /// Sends every changed column range to the OLED.
+   /// \details
+   /// The first flush sends everything, since it isn't known what the OLED shows at startup.
+   void flush() override {
+      flushed_bytes = 0;
+      for( int p = 0; p < height / 8; p++ ){
+         int first = width;
+         int last = -1;
+         for( int x = 0; x < width; x++ ){
+            int i = p * width + x;
+            if( !sent_valid || pixels[ i ] != sent[ i ] ){
+               if( first == width ){
+                  first = x;
+               }
+               last = x;
+            }
+         }
+         if( last >= 0 ){
+            send_page( p, first, last );
+         }
+      }
+      sent_valid = true;
+   }
+   
+   /// \brief
+   /// Returns the amount of bytes the last flush sent over the bus, commands included.
+   uint32_t get_flushed_bytes() const {
+      return flushed_bytes;
+   }
+};
+
+#endif
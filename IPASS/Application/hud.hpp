@@ -0,0 +1,84 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef HUD_HPP
+#define HUD_HPP
+
+class hud : public drawable {
+private:
+
+   static constexpr int columns = 11;
+   static constexpr int winning_score = 4;
+
+   int score_1 = 0;
+   int score_2 = 0;
+   int winner = 0;
+   bool changed = true;
+   uint32_t renders = 0;
+   
+   window_paged_buffer< columns * 8, 8 > surface;
+   hwlib::font_default_8x8 font;
+   hwlib::terminal_from text;
+   
+   // Renders the score or the winner into the surface, centered in its 11 characters.
+   void render(){
+      IPASS_PROFILE_SCOPE( profiling::section::score );
+      if( winner != 0 ){
+         text << "\f\t0100P" << winner << " WINS!!" << hwlib::flush;
+      } else {
+         text << "\f\t0300" << score_1 << " - " << score_2 << hwlib::flush;
+      }
+      changed = false;
+      renders++;
+   }
+
+public:
+
+   hud( window_paged & w, const hwlib::xy & location ):
+      drawable( w, location, hwlib::xy( columns * 8, 8 ) ),
+      text( surface, font )
+   {}
+   
+   /// \brief
+   /// Gives a point to player 1 or 2, returns true when that player has won.
+   bool add_point( const int & player ){
+      if( player == 1 ){
+         score_1++;
+      } else {
+         score_2++;
+      }
+      if( score_1 == winning_score || score_2 == winning_score ){
+         winner = player;
+      }
+      changed = true;
+      return winner != 0;
+   }
+   
+   /// \brief
+   /// Puts both scores back to 0 for a new game.
+   void reset(){
+      score_1 = 0;
+      score_2 = 0;
+      winner = 0;
+      changed = true;
+   }
+   
+   /// \brief
+   /// Copies the text into the window, it is only rendered again when the score changed.
+   void draw() override {
+      if( changed ){
+         render();
+      }
+      w.blit( surface, location );
+   }
+   
+   /// \brief
+   /// Returns how often the text was rendered since the hud was made.
+   uint32_t get_renders() const {
+      return renders;
+   }
+};
+
+#endif
@@ -14,15 +14,21 @@ protected:
    
 public:
 
-    line( hwlib::window & w, const hwlib::xy & location, const hwlib::xy & end, const hwlib::xy & moving_cube_angle):
+    line( window_paged & w, const hwlib::xy & location, const hwlib::xy & end, const hwlib::xy & moving_cube_angle):
       drawable( w, location, end - location , moving_cube_angle),
       end( end )
     {}
    
    
     void draw() override {
-      hwlib::line x( location, end );
-      x.draw( w );;
+      if( location.y == end.y ){
+         w.hline( location.x, end.x, location.y );
+      } else if( location.x == end.x ){
+         w.vline( location.x, location.y, end.y );
+      } else {
+         hwlib::line x( location, end );
+         x.draw( w );
+      }
     }
 };
 
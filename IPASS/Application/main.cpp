@@ -1,123 +1,317 @@
 #include "hwlib.hpp"
 #include "registers.hpp"
 #include "helper.hpp"
+#include "i2c_backend.hpp"
+#include "i2c_backend_bit_banged.hpp"
+#include "i2c_backend_twi.hpp"
 #include "i2c_ipass.hpp"
 #include "ADXL345.hpp"
+#include "fixed.hpp"
+#include "ADXL345_sampler.hpp"
+#include "ring_buffer.hpp"
+#include "sample_filters.hpp"
+#include "ADXL345_gestures.hpp"
+#include "sample_recording.hpp"
+#include "profiling.hpp"
+#include "latency_histogram.hpp"
 #include "tests.hpp"
+#include "window_paged.hpp"
+#include "glcd_oled_paged.hpp"
 #include "drawable.hpp"
 #include "line.hpp"
 #include "cube.hpp"
 #include "moving_cube.hpp"
 #include "player.hpp"
+#include "hud.hpp"
+#include "frame_scheduler.hpp"
+#include "entity_store.hpp"
+#include "pong.hpp"
+
+// Pushes the samples one sensor's FIFO collected into its ring buffer with the time each was taken.
+void push_samples(ring_buffer< timed_sample, 64 > & buffer, ADXL345 & accelerometer, const uint_fast64_t & time_us, const ADXL345::sample samples[], const size_t & amount){
+    for(size_t i = 0; i < amount; i++){
+        timed_sample s;
+        s.time_us = time_us - (amount - 1 - i) * accelerometer.sample_period_us();
+        s.value = samples[i];
+        buffer.push(s);
+    }
+}
+
+// Button that reports a press once, the bouncing of the contacts is ignored for 50 ms after a change without waiting for it.
+struct debounced_button {
+    hwlib::pin_in & pin;
+    bool down = false;
+    uint_fast64_t last_change = 0;
+    
+    debounced_button(hwlib::pin_in & pin): pin(pin) {}
+    
+    bool pressed(){
+        auto now = hwlib::now_us();
+        if(now - last_change < 50000){
+            return false;
+        }
+        bool new_down = pin.read();
+        if(new_down == down){
+            return false;
+        }
+        down = new_down;
+        last_change = now;
+        return down;
+    }
+};
+
  
 int main( void ){
     
     namespace target = hwlib::target;
  
+    // The sensors and the display all go through this backend, so on the Due the TWI controller can have pin 20 and 21.
+#ifdef HWLIB_TARGET_arduino_due
+    i2c_backend_twi backend(400000);
+#else
     auto scl = target::pin_oc( target::pins::scl );
     auto sda = target::pin_oc( target::pins::sda );
  
-    auto i2c_bus = hwlib::i2c_bus_bit_banged_scl_sda( scl,sda );
+    i2c_backend_bit_banged backend(scl, sda, i2c_backend_bit_banged::fast_mode);
+#endif
     
     auto btn1 = hwlib::target::pin_in( hwlib::target::pins::d22 );
     auto btn2 = hwlib::target::pin_in( hwlib::target::pins::d24 );
     auto btn3 = hwlib::target::pin_in( hwlib::target::pins::d26 );
+    debounced_button measure_button( btn1 );
+    debounced_button standby_button( btn2 );
+    debounced_button start_button( btn3 );
     
+    auto int1_sensor1 = hwlib::target::pin_in( hwlib::target::pins::d28 );
+    auto int1_sensor2 = hwlib::target::pin_in( hwlib::target::pins::d30 );
     
-    auto oled    = hwlib::glcd_oled( i2c_bus, 0x3c );
+    
+    glcd_oled_paged oled( backend, 0x3c );
     auto font    = hwlib::font_default_8x8();
     auto display = hwlib::terminal_from( oled, font );
 
-    i2c_ipass i2c_ipass_object(i2c_bus);
+    i2c_ipass i2c_ipass_object(backend);
 
-    ADXL345 accelerometer(i2c_bus, 0x53, -5, 4, 8);
-    ADXL345 accelerometer2(i2c_bus, 0x1D, 0, 2, -6);
+    ADXL345 accelerometer(backend, 0x53, -5, 4, 8);
+    ADXL345 accelerometer2(backend, 0x1D, 0, 2, -6);
+    
+    ADXL345_sampler< 2 > sensors({ &accelerometer, &accelerometer2 });
+    ADXL345_sampler< 2 >::fifo_frame fifo_data;
+    std::array< ring_buffer< timed_sample, 64 >, 2 > sample_buffers;
     
     tests test_object(i2c_ipass_object, accelerometer);
     
-    test_object.print_test_results();
+    // The calibrate test needs the sensors lying flat, so like the calibration below it only runs with the D22 button held.
+    test_object.print_test_results(btn1.read());
+    
+    if(sensors.discover() < 2){
+        hwlib::cout << "Not every sensor answers, check the wiring" << hwlib::endl;
+    }
     
     accelerometer.setup(1);
     accelerometer2.setup(1);    
+    
+    // Hold the D22 button during startup with both sensors lying flat to calibrate them.
+    // The offsets are printed so they can be put in the constructors above, then this isn't needed on the next boot.
+    if(btn1.read()){
+        int number = 1;
+        for(auto & sensor : { &accelerometer, &accelerometer2 }){
+            auto measured = sensor->calibrate(ADXL345::orientation::z_up);
+            hwlib::cout << "Offsets of sensor " << number++ << ": " 
+                << static_cast<int>(measured.x) << ", " 
+                << static_cast<int>(measured.y) << ", " 
+                << static_cast<int>(measured.z) << hwlib::endl;
+        }
+    }
+    // The settings of each sensor are collected in a batch, so they go over the bus in a few bursts instead of a write per register.
+    // Tap detection needs at least 100 Hz, the second sensor is only read for the display so it can stay slow.
+    // Tap the first sensor twice to start the game or go back to the sensor display, tap it once to pause or continue the game.
+    gesture_queue< 8 > gestures;
+    accelerometer.begin_batch();
+    accelerometer.set_data_rate< ADXL345::data_rate::hz_100, true >();
+    accelerometer.set_data_format< ADXL345::data_format< ADXL345::range::g4, true > >();
+    accelerometer.set_tap_detection(ADXL345::tap_config());
+    accelerometer.set_interrupts(ADXL345::single_tap | ADXL345::double_tap);
+    accelerometer.apply_batch();
+    accelerometer2.begin_batch();
+    accelerometer2.set_data_rate< ADXL345::data_rate::hz_25, true >();
+    accelerometer2.set_data_format< ADXL345::data_format< ADXL345::range::g4, true > >();
+    accelerometer2.apply_batch();
 
-    line top( oled, hwlib::xy(   0,  0 ), hwlib::xy( 127,  0 ) , hwlib::xy(1,-1));
-    line right( oled, hwlib::xy( 127,  0 ), hwlib::xy( 127, 63 ), hwlib::xy(4,4) );
-    line bottom( oled, hwlib::xy(   0, 63 ), hwlib::xy( 127, 63 ), hwlib::xy(1,-1) );
-    line left( oled, hwlib::xy(   0,  0 ), hwlib::xy(   0, 63 ), hwlib::xy(3, 3)  );
-    player player_1( oled, hwlib::xy(   10, 24 ), hwlib::xy(   10, 37  ), hwlib::xy(-1,1)  );
-    player player_2( oled, hwlib::xy(   117, 24 ), hwlib::xy(   117, 37  ), hwlib::xy(-1,1)  );
-    moving_cube mc( oled, hwlib::xy( 20, 27 ), 3, hwlib::xy( 5, 2 ) );
-
-    std::array< drawable *, 7 > objects = { &mc, &top, &left, &right, &bottom, &player_1, &player_2 };
+    pong game( oled );
+    
+    // The game updates every 40 ms and draws at 25 frames per second, the speeds of the ball and the paddles are per update.
+    frame_scheduler scheduler( 40000, 40000 );
+    
+    // Time from a sensor sample until the flush that shows the paddle moved by it has finished, traced when profiling is on.
+    latency_histogram input_latency;
+    std::array< latency_tracer< 64 >, 2 > input_tracers;
     
     int playing = 0;
+    bool paused = false;
+    
+    auto start_game = [&](){
+        playing = 1;
+        paused = false;
+        game.reset();
+        accelerometer.begin_batch();
+        accelerometer.set_data_rate< ADXL345::data_rate::hz_100 >();
+        accelerometer.set_fifo_mode(ADXL345::fifo_mode::stream, 8);
+        accelerometer.set_interrupts(ADXL345::watermark | ADXL345::single_tap | ADXL345::double_tap);
+        accelerometer.apply_batch();
+        accelerometer2.begin_batch();
+        accelerometer2.set_data_rate< ADXL345::data_rate::hz_100 >();
+        accelerometer2.set_fifo_mode(ADXL345::fifo_mode::stream, 8);
+        accelerometer2.set_interrupts(ADXL345::watermark);
+        accelerometer2.apply_batch();
+        scheduler.start();
+    };
+    
+    // Back to the low power rates of the startup: the first sensor still has to detect taps, the second is only shown.
+    auto stop_game = [&](){
+        playing = 0;
+        accelerometer.begin_batch();
+        accelerometer.set_data_rate< ADXL345::data_rate::hz_100, true >();
+        accelerometer.set_fifo_mode(ADXL345::fifo_mode::bypass, 0);
+        accelerometer.set_interrupts(ADXL345::single_tap | ADXL345::double_tap);
+        accelerometer.apply_batch();
+        accelerometer2.begin_batch();
+        accelerometer2.set_data_rate< ADXL345::data_rate::hz_25, true >();
+        accelerometer2.set_fifo_mode(ADXL345::fifo_mode::bypass, 0);
+        accelerometer2.set_interrupts(0);
+        accelerometer2.apply_batch();
+    };
+ 
+#ifdef IPASS_RECORD
+    // Compiled with IPASS_RECORD the serial port carries a recording of the samples, gestures and buttons instead of the statistics.
+    // The Simulator can play it back, see sample_recorder for the format.
+    sample_recorder recorder(hwlib::cout);
+    recorder.start();
+#endif
+    auto record_button = [&](const uint8_t & number){
+#ifdef IPASS_RECORD
+        recorder.button(number, hwlib::now_us());
+#else
+        (void)number;
+#endif
+    };
  
     for(;;){
-        if(btn1.read()){
+        if(measure_button.pressed()){
+            record_button(1);
             accelerometer.set_measuring_mode();
-            hwlib::wait_ms(500);
-        } else if (btn2.read()){
+        } else if (standby_button.pressed()){
+            record_button(2);
             accelerometer.set_standby_mode();
-            hwlib::wait_ms(500);
         }
         
-        
-        if(playing == 0){
-            if(btn3.read()){
-                playing = 1;
-                hwlib::wait_ms(500);
+        uint8_t source_1 = gestures.poll(accelerometer, int1_sensor1);
+        bool toggle_game = start_button.pressed();
+        if(toggle_game){
+            record_button(3);
+        }
+        gesture_event event;
+        while(gestures.pop(event)){
+#ifdef IPASS_RECORD
+            recorder.gesture(0, event);
+#endif
+            if(event.type == ADXL345::double_tap){
+                toggle_game = true;
+            } else if((event.type == ADXL345::single_tap) && (playing == 1)){
+                paused = !paused;
+                if(!paused){
+                    scheduler.start();
+                }
+            }
+        }
+        if(toggle_game){
+            if(playing == 0){
+                start_game();
+            } else {
+                stop_game();
             }
-            int axis_data[3];
+            continue;
+        }
         
-            int axis_data2[3];
-            
-            accelerometer.read_all_axis_2g(axis_data);
-            accelerometer2.read_all_axis_2g(axis_data2);
+        if(playing == 0){
+            auto axis_data = sensors.read();
 
             display 
-             << "\f" << "X: " << axis_data[0]
-             << "\n" << "Y: " << axis_data[1]
-             << "\n" << "Z: " << axis_data[2]
+             << "\f" << "X: " << accelerometer.to_milli_g(axis_data.samples[0].x)
+             << "\n" << "Y: " << accelerometer.to_milli_g(axis_data.samples[0].y)
+             << "\n" << "Z: " << accelerometer.to_milli_g(axis_data.samples[0].z)
              << "\n"
-             << "\n" << "X2: " << axis_data2[0]
-             << "\n" << "Y2: " << axis_data2[1]
-             << "\n" << "Z2: " << axis_data2[2]
+             << "\n" << "X2: " << accelerometer2.to_milli_g(axis_data.samples[1].x)
+             << "\n" << "Y2: " << accelerometer2.to_milli_g(axis_data.samples[1].y)
+             << "\n" << "Z2: " << accelerometer2.to_milli_g(axis_data.samples[1].z)
              << hwlib::flush;
              
         } else {
-            int player_1_y_axis = accelerometer.read_axis_2g(DATAY0,DATAY1);
-            int player_2_y_axis = accelerometer2.read_axis_2g(DATAY0,DATAY1);
-            
-            if(player_1_y_axis > 30){
-                player_1.set_speed(2);
-            } else if(player_1_y_axis < -30){
-                player_1.set_speed(-2);
-            } else {
-                player_1.set_speed(0);
+            IPASS_PROFILE_SCOPE( profiling::section::frame );
+            {
+                IPASS_PROFILE_SCOPE( profiling::section::sensors );
+                bool watermark_1 = source_1 & ADXL345::watermark;
+                bool watermark_2 = accelerometer2.poll_interrupt(int1_sensor2) & ADXL345::watermark;
+                if(watermark_1 || watermark_2){
+                    sensors.drain(fifo_data);
+                    push_samples(sample_buffers[0], accelerometer, fifo_data.time_us, fifo_data.samples[0], fifo_data.amounts[0]);
+                    push_samples(sample_buffers[1], accelerometer2, fifo_data.time_us, fifo_data.samples[1], fifo_data.amounts[1]);
+                }
+                
+                // The paddles only move while the game is played, a sample taken during a pause or the score screen is never shown so it isn't traced.
+                for(size_t i = 0; i < 2; i++){
+                    sample_buffers[i].pop_all([&](const timed_sample & s){
+                        game.add_sample(i, s);
+#ifndef IPASS_NO_PROFILING
+                        if(game.playing() && !paused){
+                            input_tracers[i].stamp(s.time_us);
+                        }
+#endif
+#ifdef IPASS_RECORD
+                        recorder.sample(i, s.time_us, s.value);
+#endif
+                    });
+                }
+                game.steer(0, accelerometer.to_milli_g(game.filtered(0).y));
+                game.steer(1, accelerometer2.to_milli_g(game.filtered(1).y));
             }
             
-            if(player_2_y_axis > 30){
-                player_2.set_speed(2);
-            } else if(player_2_y_axis < -30){
-                player_2.set_speed(-2);
-            } else {
-                player_2.set_speed(0);
+            // After a point the score is shown for a second and after a win the winner, the sensors keep being read meanwhile.
+            if(!game.playing()){
+                if(game.resume(hwlib::now_us())){
+                    scheduler.start();
+                }
+            } else if(!paused){
+                IPASS_PROFILE_SCOPE( profiling::section::collision );
+                game.play(scheduler.steps(), hwlib::now_us());
             }
             
-            oled.clear();
-            for( auto & p : objects ){
-             p->draw();
+            {
+                IPASS_PROFILE_SCOPE( profiling::section::draw );
+                game.draw();
             }
-            oled.flush();
-            hwlib::wait_ms( 100 );
-            for( auto & p : objects ){
-              p->update();
+            {
+                IPASS_PROFILE_SCOPE( profiling::section::flush );
+                oled.flush();
             }
-            for( auto & p : objects ){
-             for( auto & other : objects ){
-                p->interact( *other );
-             } 
+#ifndef IPASS_NO_PROFILING
+            {
+                auto shown_us = hwlib::now_us();
+                for(size_t i = 0; i < 2; i++){
+                    input_tracers[i].shown(game.get_paddle(i).input_time_us(), shown_us, input_latency);
+                }
+            }
+#endif
+            
+            scheduler.wait();
+#ifndef IPASS_RECORD
+            if( scheduler.get_frames() == 250 ){
+                hwlib::cout << scheduler << "\n" << profiling::statistics() << "\ninput latency " << input_latency << hwlib::endl;
+                scheduler.reset_statistics();
+                profiling::reset();
+                input_latency.reset();
             }
+#endif
         }
     }
 }
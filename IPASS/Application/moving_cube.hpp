@@ -5,73 +5,86 @@
 //          https://www.boost.org/LICENSE_1_0.txt)
 
 #ifndef MOVING_CUBE_HPP
-#define MOCING_CUBE_HPP
+#define MOVING_CUBE_HPP
 
-class moving_cube : public cube {
+class moving_cube final : public cube {
 private:
 
-   hwlib::xy speed;
-   int score_1 = 0;
-   int score_2 = 0;
+   fixed_xy position;
+   fixed_xy previous_position;
+   fixed_xy speed;
+   fixed_xy start_speed;
+   int point = 0;
+   
+   void serve( const hwlib::xy & start, const fixed_xy & new_speed ){
+      position = fixed_xy( start );
+      previous_position = position;
+      location = start;
+      previous_location = start;
+      speed = new_speed;
+   }
    
 public:
 
    moving_cube( 
-      hwlib::window & w, 
+      window_paged & w, 
       const hwlib::xy & midpoint, 
       int radius, 
-      const hwlib::xy & speed 
+      const fixed_xy & speed 
    ):
       cube( w, midpoint, radius ),
-      speed( speed )  
+      position( location ),
+      previous_position( location ),
+      speed( speed ),
+      start_speed( speed )
    {}
    
    void update() override {
-      location = location + speed; 
+      previous_position = position;
+      position = position + speed;
+      location = position.rounded();
+   }
+   
+   /// \brief
+   /// Returns which player (1 or 2) scored since the last call, or 0 when nobody did.
+   /// \details
+   /// The ball goes back to the serve position by itself, showing the score is up to the game loop.
+   int take_point(){
+      int scored = point;
+      point = 0;
+      return scored;
    }
    
    void interact( drawable & other ) override {
       if( this != & other){
-         if( overlaps( other )){
+         int impact = time_of_impact( other );
+         if( impact >= 0 ){
             auto moving_cube_angle = other.get_moving_cube_angle();
             if(moving_cube_angle.x < 2 && moving_cube_angle.y < 2){
-                speed.x *= moving_cube_angle.x;
-                speed.y *= moving_cube_angle.y;
+                // Go back to where the ball hit, bounce, and use the rest of the step to move away in the new direction.
+                // The impact is a fraction of the path that is left of this step, after an earlier bounce in the same step that is less than the speed.
+                fixed part = fixed::from_fixed( impact );
+                fixed_xy path = position - previous_position;
+                fixed_xy hit = previous_position + path * part;
+                fixed_xy rest = path - path * part;
+                speed.x = speed.x * moving_cube_angle.x;
+                speed.y = speed.y * moving_cube_angle.y;
+                rest.x = rest.x * moving_cube_angle.x;
+                rest.y = rest.y * moving_cube_angle.y;
+                position = hit + rest;
+                location = position.rounded();
+                if( part < fixed( 1 ) ){
+                   previous_position = hit;
+                   previous_location = hit.rounded();
+                }
             } else {
                 if(moving_cube_angle.x == 3){
-                    score_2 += 1;
-                    location.x = 20;
-                    location.y = 27;
-                    speed.x = 5;
-                    speed.y = 2;                    
+                    point = 2;
+                    serve( hwlib::xy( 20, 27 ), start_speed );
                 } else if(moving_cube_angle.x == 4) {
-                    score_1 += 1;
-                    location.x = 107;
-                    location.y = 27;
-                    speed.x = -5;
-                    speed.y = -2;
-                }
-                w.clear();
-                auto font    = hwlib::font_default_8x8();
-                auto display = hwlib::terminal_from( w, font );
-                if(score_1 < 4 && score_2 < 4){
-                display 
-                     << "\t0503" << score_1 << " - " << score_2
-                     << hwlib::flush;
-                } else {
-                    if(score_1 == 4){
-                         display 
-                             << "\t0303" << " P1 WINS!!"
-                             << hwlib::flush;
-                    } else {
-                        display 
-                             << "\t0303" << " P2 WINS!!"
-                             << hwlib::flush;
-                    }
-                    score_1 = 0;
-                    score_2 = 0;
+                    point = 1;
+                    serve( hwlib::xy( 107, 27 ), fixed_xy() - start_speed );
                 }
-                hwlib::wait_ms(1000);
             }
          }
       }
@@ -7,23 +7,49 @@
 #ifndef PLAYER_HPP
 #define PLAYER_HPP
 
-class player : public line {
+class player final : public line {
 private:
-    int speed = 0;
+    fixed top;
+    fixed speed;
+    uint_fast64_t input_us = 0;
+    uint_fast64_t moved_input_us = 0;
    
 public:
 
-    player( hwlib::window & w, const hwlib::xy & location, const hwlib::xy & end, const hwlib::xy & moving_cube_angle):
-      line( w, location, end, moving_cube_angle)
+    player( window_paged & w, const hwlib::xy & location, const hwlib::xy & end, const hwlib::xy & moving_cube_angle):
+      line( w, location, end, moving_cube_angle),
+      top( location.y )
     {}
     
-    void set_speed(const int & new_speed){
+    /// \brief
+    /// Sets the speed in pixels per step, it doesn't have to be whole pixels.
+    /// \details
+    /// sample_time_us is when the newest sensor sample behind the speed was taken, it is carried along for the latency measurement.
+    void set_speed(const fixed & new_speed, const uint_fast64_t & sample_time_us = 0){
         speed = new_speed;
+        input_us = sample_time_us;
+    }
+    
+    /// \brief
+    /// Returns when the newest sample that the current position is based on was taken.
+    /// \details
+    /// It only changes in update, so after a flush it tells how old the input is that the screen now shows.
+    uint_fast64_t input_time_us() const {
+        return moved_input_us;
     }
    
+    /// \brief
+    /// Moves the paddle, it stops against the top and the bottom wall.
     void update() override {
-        location.y = location.y + speed;
-        end.y = end.y + speed;      
+        top += speed;
+        moved_input_us = input_us;
+        if(top < fixed(1)){
+            top = fixed(1);
+        } else if(top > fixed(w.size.y - 2 - size.y)){
+            top = fixed(w.size.y - 2 - size.y);
+        }
+        location.y = top.whole();
+        end.y = location.y + size.y;
     }
    
 };
@@ -0,0 +1,188 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef PONG_HPP
+#define PONG_HPP
+
+// Filters the tilt of one paddle: the median takes out single bad reads, the exponential filter smooths what is left.
+// newest_us is the time of the newest sample, it goes along with the speed to measure the latency from sensor to screen.
+struct paddle_filter {
+   median_filter< 5 > median;
+   exponential_filter< 2 > smooth;
+   uint_fast64_t newest_us = 0;
+
+   void add( const timed_sample & s ){
+      median.add( s.value );
+      smooth.add( median.value() );
+      newest_us = s.time_us;
+   }
+};
+
+// Turns the tilt of a sensor into the speed of a paddle.
+// Below 50 mg the paddle stands still so a sensor that lies flat doesn't drift, above that every 250 mg is 1 pixel per step up to 3 pixels per step.
+inline fixed paddle_speed( const milli_g & y_axis ){
+   int32_t tilt = y_axis.whole();
+   if( tilt > -50 && tilt < 50 ){
+      return fixed( 0 );
+   }
+   if( tilt > 750 ){
+      tilt = 750;
+   } else if( tilt < -750 ){
+      tilt = -750;
+   }
+   return fixed::from_fixed( ( tilt * 256 ) / 250 );
+}
+
+/// \brief
+/// The game of PONG: the walls, the ball, the paddles, the score and the filters that turn samples into paddle speeds.
+/// \details
+/// Example: pong game( oled ); game.add_sample( 0, s ); game.steer( 0, tilt ); game.play( scheduler.steps(), hwlib::now_us() ); game.draw(); oled.flush();
+///
+/// It knows nothing about the sensors, the bus or the frame timing, those stay with the caller.
+/// That way main.cpp plays it on the Due and the Simulator plays the same game on a simulated bus and clock.
+/// After a point the score is shown for a second and after a win the winner, resume() goes back to the game after that.
+class pong {
+public:
+
+   enum class game_state { playing, scored, won };
+
+private:
+
+   window_paged & w;
+   entity_store< std::array< line, 4 >, std::array< moving_cube, 1 >, std::array< player, 2 > > entities;
+   moving_cube & ball;
+   std::array< player *, 2 > paddles;
+   hud score_board;
+   std::array< paddle_filter, 2 > filters;
+   game_state state = game_state::playing;
+   uint_fast64_t state_end = 0;
+
+public:
+
+   // The walls never move, the ball and the paddles are updated every step.
+   pong( window_paged & w ):
+      w( w ),
+      entities(
+         w.size,
+         {{
+            line( w, hwlib::xy(   0,  0 ), hwlib::xy( 127,  0 ) , hwlib::xy(1,-1)),
+            line( w, hwlib::xy( 127,  0 ), hwlib::xy( 127, 63 ), hwlib::xy(4,4) ),
+            line( w, hwlib::xy(   0, 63 ), hwlib::xy( 127, 63 ), hwlib::xy(1,-1) ),
+            line( w, hwlib::xy(   0,  0 ), hwlib::xy(   0, 63 ), hwlib::xy(3, 3)  )
+         }},
+         {{ moving_cube( w, hwlib::xy( 20, 27 ), 3, fixed_xy( fixed( 2 ), fixed( 1 ) ) ) }},
+         {{
+            player( w, hwlib::xy(   10, 24 ), hwlib::xy(   10, 37  ), hwlib::xy(-1,1)  ),
+            player( w, hwlib::xy(   117, 24 ), hwlib::xy(   117, 37  ), hwlib::xy(-1,1)  )
+         }}
+      ),
+      ball( entities.dynamic< 0 >()[ 0 ] ),
+      paddles{{ &entities.dynamic< 1 >()[ 0 ], &entities.dynamic< 1 >()[ 1 ] }},
+      score_board( w, hwlib::xy( 20, 24 ) )
+   {}
+
+   /// \brief
+   /// Starts a new game: the score goes back to 0 - 0 and the game is shown.
+   void reset(){
+      state = game_state::playing;
+      score_board.reset();
+   }
+
+   /// \brief
+   /// Adds a sample of the sensor of paddle 0 or 1 to the filter of that paddle.
+   void add_sample( const size_t & paddle, const timed_sample & s ){
+      filters[ paddle ].add( s );
+   }
+
+   /// \brief
+   /// Returns the filtered raw sample of the sensor of paddle 0 or 1.
+   ADXL345::sample filtered( const size_t & paddle ) const {
+      return filters[ paddle ].smooth.value();
+   }
+
+   /// \brief
+   /// Sets the speed of paddle 0 or 1 from the tilt of its sensor.
+   /// \details
+   /// The time of the newest sample in the filter goes along for the latency measurement.
+   void steer( const size_t & paddle, const milli_g & tilt ){
+      paddles[ paddle ]->set_speed( paddle_speed( tilt ), filters[ paddle ].newest_us );
+   }
+
+   /// \brief
+   /// Returns true while the game is shown, false while the score or the winner is.
+   bool playing() const {
+      return state == game_state::playing;
+   }
+
+   /// \brief
+   /// Goes back to the game once the score or the winner has been shown for a second.
+   /// \details
+   /// Returns true when it did, so the caller can restart the timing of its frames. After a win the score starts over.
+   bool resume( const uint_fast64_t & now_us ){
+      if( playing() || now_us < state_end ){
+         return false;
+      }
+      if( state == game_state::won ){
+         score_board.reset();
+      }
+      state = game_state::playing;
+      return true;
+   }
+
+   /// \brief
+   /// Does up to steps steps of the game, it stops at the step in which a point is scored.
+   /// \details
+   /// between() is called in every step after the drawables moved and before they collide, so the cost of both can be measured.
+   template< typename F >
+   void play( const int & steps, const uint_fast64_t & now_us, F && between ){
+      for( int n = steps; n > 0 && playing(); n-- ){
+         entities.move();
+         between();
+         entities.collide();
+         int point = ball.take_point();
+         if( point != 0 ){
+            state = score_board.add_point( point ) ? game_state::won : game_state::scored;
+            state_end = now_us + 1000000;
+         }
+      }
+   }
+
+   /// \brief
+   /// Does up to steps steps of the game, it stops at the step in which a point is scored.
+   void play( const int & steps, const uint_fast64_t & now_us ){
+      play( steps, now_us, [](){} );
+   }
+
+   /// \brief
+   /// Clears the window and draws the game, or the score while that is shown. Flushing is up to the caller.
+   void draw(){
+      w.clear();
+      if( playing() ){
+         entities.draw();
+      } else {
+         score_board.draw();
+      }
+   }
+
+   /// \brief
+   /// Returns the ball.
+   const moving_cube & get_ball() const {
+      return ball;
+   }
+
+   /// \brief
+   /// Returns paddle 0 or 1.
+   const player & get_paddle( const size_t & paddle ) const {
+      return *paddles[ paddle ];
+   }
+
+   /// \brief
+   /// Returns the state the game is in.
+   game_state get_state() const {
+      return state;
+   }
+};
+
+#endif
@@ -0,0 +1,156 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef WINDOW_PAGED_HPP
+#define WINDOW_PAGED_HPP
+
+#include "hwlib.hpp"
+#include <algorithm>
+
+/// \brief
+/// Window that keeps its pixels in memory in the page layout of the SSD1306 OLED.
+/// \details
+/// Every byte holds 8 pixels below each other, bit 0 is the top one.
+/// A row of size.x of those bytes is a page of 8 pixel rows, so byte (x, page) holds the pixels (x, page * 8) up to (x, page * 8 + 7).
+/// A set bit is a lit (white) pixel.
+///
+/// The buffer is given by the class that derives from this one, it has to be size.x * ((size.y + 7) / 8) bytes.
+class window_paged : public hwlib::window {
+protected:
+
+   uint8_t * buffer;
+
+   void write_implementation( hwlib::xy pos, hwlib::color col ) override {
+      uint8_t & byte = buffer[ pos.x + ( pos.y / 8 ) * size.x ];
+      uint8_t bit = 1 << ( pos.y % 8 );
+      if( col == hwlib::white ){
+         byte |= bit;
+      } else {
+         byte &= ~bit;
+      }
+   }
+
+public:
+
+   window_paged( const hwlib::xy & size, uint8_t * buffer ):
+      hwlib::window( size, hwlib::white, hwlib::black ),
+      buffer( buffer )
+   {}
+   
+   using hwlib::window::clear;
+   
+   /// \brief
+   /// Fills the whole window with one color a byte at a time instead of a pixel at a time.
+   void clear( hwlib::color col ) override {
+      uint8_t fill = ( col == hwlib::white ) ? 0xFF : 0x00;
+      for( int i = 0; i < size.x * pages(); i++ ){
+         buffer[ i ] = fill;
+      }
+   }
+   
+   /// \brief
+   /// Fills the rectangle from start up to and including end, a page byte at a time.
+   /// \details
+   /// Example: w.fill_rect( hwlib::xy( 10, 10 ), hwlib::xy( 15, 15 ) );
+   ///
+   /// Every column of a page is a single OR or AND with a mask of the rows the rectangle covers in that page, instead of a virtual write per pixel.
+   /// The rectangle is clipped to the window.
+   void fill_rect( const hwlib::xy & start, const hwlib::xy & end, hwlib::color col = hwlib::white ){
+      int x0 = std::max< int >( std::min( start.x, end.x ), 0 );
+      int y0 = std::max< int >( std::min( start.y, end.y ), 0 );
+      int x1 = std::min< int >( std::max( start.x, end.x ), size.x - 1 );
+      int y1 = std::min< int >( std::max( start.y, end.y ), size.y - 1 );
+      if( x0 > x1 || y0 > y1 ){
+         return;
+      }
+      for( int p = y0 / 8; p <= y1 / 8; p++ ){
+         int top = std::max( y0, p * 8 ) - p * 8;
+         int bottom = std::min( y1, p * 8 + 7 ) - p * 8;
+         uint8_t mask = ( 0xFF << top ) & ( 0xFF >> ( 7 - bottom ) );
+         uint8_t * byte = buffer + p * size.x + x0;
+         for( int x = x0; x <= x1; x++, byte++ ){
+            if( col == hwlib::white ){
+               *byte |= mask;
+            } else {
+               *byte &= ~mask;
+            }
+         }
+      }
+   }
+   
+   /// \brief
+   /// Draws a horizontal line from x0 up to and including x1 on row y.
+   void hline( int x0, int x1, int y, hwlib::color col = hwlib::white ){
+      fill_rect( hwlib::xy( x0, y ), hwlib::xy( x1, y ), col );
+   }
+   
+   /// \brief
+   /// Draws a vertical line from y0 up to and including y1 in column x.
+   void vline( int x, int y0, int y1, hwlib::color col = hwlib::white ){
+      fill_rect( hwlib::xy( x, y0 ), hwlib::xy( x, y1 ), col );
+   }
+   
+   /// \brief
+   /// Draws the lit pixels of another window_paged with its top left corner at pos.
+   /// \details
+   /// Example: w.blit( text_surface, hwlib::xy( 20, 24 ) );
+   ///
+   /// Every byte of the source is ORed into the window, shifted over 2 pages when pos.y isn't a multiple of 8.
+   /// That makes drawing a pre-rendered text a few byte operations per column instead of a write per pixel.
+   /// Pixels that fall outside of the window are skipped.
+   void blit( const window_paged & source, const hwlib::xy & pos ){
+      int shift = ( ( pos.y % 8 ) + 8 ) % 8;
+      int first_page = ( pos.y - shift ) / 8;
+      for( int p = 0; p < source.pages(); p++ ){
+         const uint8_t * from = source.page( p );
+         int low_page = first_page + p;
+         for( int x = 0; x < source.size.x; x++ ){
+            int column = pos.x + x;
+            if( column < 0 || column >= size.x || from[ x ] == 0 ){
+               continue;
+            }
+            if( low_page >= 0 && low_page < pages() ){
+               buffer[ low_page * size.x + column ] |= from[ x ] << shift;
+            }
+            if( shift != 0 && low_page + 1 >= 0 && low_page + 1 < pages() ){
+               buffer[ ( low_page + 1 ) * size.x + column ] |= from[ x ] >> ( 8 - shift );
+            }
+         }
+      }
+   }
+   
+   /// \brief
+   /// Returns the amount of pages, which is the height divided by 8 rounded up.
+   int pages() const {
+      return ( size.y + 7 ) / 8;
+   }
+   
+   /// \brief
+   /// Returns the size.x bytes of the given page.
+   const uint8_t * page( int p ) const {
+      return buffer + ( p * size.x );
+   }
+};
+
+/// \brief
+/// window_paged with its own buffer of W x H pixels.
+/// \details
+/// Example: window_paged_buffer< 88, 8 > text_surface;
+///
+/// Handy to render something once, like a text, and blit it into the screen every frame.
+template< int W, int H >
+class window_paged_buffer : public window_paged {
+private:
+
+   uint8_t storage[ W * ( ( H + 7 ) / 8 ) ] = {};
+
+public:
+
+   window_paged_buffer():
+      window_paged( hwlib::xy( W, H ), storage )
+   {}
+};
+
+#endif
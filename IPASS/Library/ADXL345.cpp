@@ -9,7 +9,24 @@
 #include "i2c_ipass.hpp"
 
 
-ADXL345::ADXL345(const hwlib::i2c_bus_bit_banged_scl_sda & i2c_bus, const uint8_t & device_id, const int & x_offset, const int & y_offset, const int & z_offset):
+// Bit i is set when register THRESH_TAP + i is kept in the shadow.
+// ACT_TAP_STATUS, INT_SOURCE and the data registers are left out because the sensor changes them by itself.
+static constexpr uint32_t shadowed_registers = 0x0FFFFFFF & ~(
+    (1UL << (ACT_TAP_STATUS - THRESH_TAP)) |
+    (1UL << (INT_SOURCE - THRESH_TAP)) |
+    (0x3FUL << (DATAX0 - THRESH_TAP))
+);
+
+
+static bool is_shadowed(const uint8_t & register_address){
+    if((register_address < THRESH_TAP) || (register_address > FIFO_CTL)){
+        return false;
+    }
+    return (shadowed_registers >> (register_address - THRESH_TAP)) & 1;
+}
+
+
+ADXL345::ADXL345(i2c_backend & i2c_bus, const uint8_t & device_id, const int & x_offset, const int & y_offset, const int & z_offset):
         i2c_ipass(i2c_bus),
         device_id(device_id),
         x_offset(x_offset),
@@ -18,48 +35,416 @@ ADXL345::ADXL345(const hwlib::i2c_bus_bit_banged_scl_sda & i2c_bus, const uint8_
     {}
 
 
+uint8_t ADXL345::get_device_id(){
+    return device_id;
+}
+
+
+bool ADXL345::is_connected(){
+    return read(DEVID, device_id) == 0xE5;
+}
+
+
 void ADXL345::setup(const bool & start_in_measure_mode){
-    write(OFSX, device_id, x_offset);
-    write(OFSY, device_id, y_offset);
-    write(OFSZ, device_id, z_offset);
+    const uint8_t offset_bytes[3] = {
+        static_cast<uint8_t>(x_offset), 
+        static_cast<uint8_t>(y_offset), 
+        static_cast<uint8_t>(z_offset)
+    };
+    write_registers(OFSX, offset_bytes, 3);
     if(start_in_measure_mode){
-        write(POWER_CTL, device_id, 8);
+        set_measuring_mode();
     }
 }
 
 
 void ADXL345::set_measuring_mode(){
-    write(POWER_CTL, device_id, 8);
+    update_bits(power_ctl::measure(1));
 }
 
 
 void ADXL345::set_standby_mode(){
-    uint8_t old_byte = read(POWER_CTL, device_id);
-    uint8_t new_byte = (old_byte & 247);
-    write(POWER_CTL, device_id, new_byte);
+    update_bits(power_ctl::measure(0));
 }
 
 
 int16_t ADXL345::read_axis_raw(const uint8_t & axis_register_address_1, const uint8_t & axis_register_address_2){
-    auto byte_0 = read(axis_register_address_1, device_id);
-    auto byte_1 = read(axis_register_address_2, device_id);
-    int16_t byte = ( byte_0 | byte_1 << 8);
+    uint8_t bytes[2];
+    if(axis_register_address_2 == axis_register_address_1 + 1){
+        read(axis_register_address_1, device_id, bytes, 2);
+    } else {
+        bytes[0] = read(axis_register_address_1, device_id);
+        bytes[1] = read(axis_register_address_2, device_id);
+    }
+    int16_t byte = ( bytes[0] | bytes[1] << 8);
     return byte;
 }
 
 
+int ADXL345::convert_2g(const int16_t & raw){
+    return (raw * 100) / 256;
+}
+
+
 int ADXL345::read_axis_2g(const uint8_t & axis_register_address_1, const uint8_t & axis_register_address_2){
-    auto byte_0 = read(axis_register_address_1, device_id);
-    auto byte_1 = read(axis_register_address_2, device_id);
-    int16_t byte = ( byte_0 | byte_1 << 8);
-    auto return_data = (byte * 100) / 256;
-    return return_data;
+    return convert_2g(read_axis_raw(axis_register_address_1, axis_register_address_2));
 }
 
 
 int* ADXL345::read_all_axis_2g(int axis_data[3]){
-    axis_data[0] = read_axis_2g(DATAX0,DATAX1);
-    axis_data[1] = read_axis_2g(DATAY0,DATAY1);
-    axis_data[2] = read_axis_2g(DATAZ0,DATAZ1);
+    auto data = read_sample();
+    axis_data[0] = convert_2g(data.x);
+    axis_data[1] = convert_2g(data.y);
+    axis_data[2] = convert_2g(data.z);
     return axis_data;
 }
+
+
+ADXL345::sample ADXL345::read_sample(){
+    uint8_t bytes[6];
+    read(DATAX0, device_id, bytes, 6);
+    sample data;
+    data.x = ( bytes[0] | bytes[1] << 8);
+    data.y = ( bytes[2] | bytes[3] << 8);
+    data.z = ( bytes[4] | bytes[5] << 8);
+    return data;
+}
+
+
+void ADXL345::set_fifo_mode(const fifo_mode & mode, const uint8_t & watermark, const bool & trigger_on_int2){
+    write_bits(fifo_ctl::mode(static_cast<uint8_t>(mode)) | fifo_ctl::trigger(trigger_on_int2) | fifo_ctl::samples(watermark));
+}
+
+
+uint8_t ADXL345::fifo_entries(){
+    return fifo_status::entries.get(read(FIFO_STATUS, device_id));
+}
+
+
+size_t ADXL345::drain(sample samples[], const size_t & n){
+    size_t entries = fifo_entries();
+    if(entries > n){
+        entries = n;
+    }
+    for(size_t i = 0; i < entries; i++){
+        samples[i] = read_sample();
+    }
+    return entries;
+}
+
+
+void ADXL345::set_interrupts(const uint8_t & enabled, const uint8_t & on_int2){
+    write_register(INT_MAP, on_int2);
+    write_register(INT_ENABLE, enabled);
+}
+
+
+uint8_t ADXL345::read_interrupt_source(){
+    return read(INT_SOURCE, device_id);
+}
+
+
+uint8_t ADXL345::poll_interrupt(hwlib::pin_in & int_pin){
+    if(!int_pin.read()){
+        return 0;
+    }
+    return read_interrupt_source();
+}
+
+
+// Divides value by step and limits it to what fits in a register.
+static uint8_t to_steps(const uint32_t & value, const uint32_t & step){
+    uint32_t steps = value / step;
+    return steps > 255 ? 255 : steps;
+}
+
+
+void ADXL345::set_tap_detection(const tap_config & config){
+    int threshold = config.threshold.whole();
+    // THRESH_TAP up to WINDOW in one burst, the offsets in between are written with the value they already have in the shadow copy.
+    uint8_t bytes[7];
+    bytes[0] = to_steps(threshold < 0 ? 0 : threshold * 2, 125);
+    for(uint8_t i = 0; i < 3; i++){
+        bytes[1 + i] = read_register(OFSX + i);
+    }
+    bytes[4] = to_steps(config.duration_us, 625);
+    bytes[5] = to_steps(config.latency_us, 1250);
+    bytes[6] = to_steps(config.window_us, 1250);
+    write_registers(THRESH_TAP, bytes, sizeof(bytes));
+    write_bits(tap_axes::axes(config.axes) | tap_axes::suppress(config.suppress));
+}
+
+
+void ADXL345::set_activity_detection(const milli_g & threshold, const uint8_t & axes, const bool & ac_coupled){
+    int whole = threshold.whole();
+    write_register(THRESH_ACT, to_steps(whole < 0 ? 0 : whole * 2, 125));
+    update_bits(act_inact_ctl::act_axes(axes) | act_inact_ctl::act_ac(ac_coupled));
+}
+
+
+uint8_t ADXL345::read_tap_status(){
+    return read_register(ACT_TAP_STATUS);
+}
+
+
+void ADXL345::set_offsets(const offsets & new_offsets){
+    x_offset = new_offsets.x;
+    y_offset = new_offsets.y;
+    z_offset = new_offsets.z;
+    const uint8_t offset_bytes[3] = {
+        static_cast<uint8_t>(new_offsets.x), 
+        static_cast<uint8_t>(new_offsets.y), 
+        static_cast<uint8_t>(new_offsets.z)
+    };
+    write_registers(OFSX, offset_bytes, 3);
+}
+
+
+ADXL345::offsets ADXL345::get_offsets(){
+    offsets current;
+    current.x = x_offset;
+    current.y = y_offset;
+    current.z = z_offset;
+    return current;
+}
+
+
+// Turns the difference between the measured and the expected average (3.9 mg per bit) into offset steps (15.6 mg), rounded and limited to an int8_t.
+static int8_t offset_steps(const int32_t & measured, const int32_t & expected){
+    int32_t difference = expected - measured;
+    int32_t steps = (difference + (difference < 0 ? -2 : 2)) / 4;
+    if(steps > 127){
+        return 127;
+    } else if(steps < -128){
+        return -128;
+    }
+    return steps;
+}
+
+
+ADXL345::offsets ADXL345::calibrate(const orientation & resting){
+    const uint8_t saved_rate = read_register(BW_RATE);
+    const uint8_t saved_format = read_register(DATA_FORMAT);
+    const uint8_t saved_fifo = read_register(FIFO_CTL);
+    const uint8_t saved_power = read_register(POWER_CTL);
+    const offsets saved_offsets = get_offsets();
+    
+    const uint8_t no_offsets[3] = {0, 0, 0};
+    write_registers(OFSX, no_offsets, 3);
+    write_bits(::data_format::full_res(1));
+    write_bits(bw_rate::rate(static_cast<uint8_t>(data_rate::hz_400)));
+    write_bits(fifo_ctl::mode(static_cast<uint8_t>(fifo_mode::bypass)));
+    write_bits(fifo_ctl::mode(static_cast<uint8_t>(fifo_mode::fifo)));
+    set_measuring_mode();
+    
+    sample samples[33];
+    size_t amount = 0;
+    auto start = hwlib::now_us();
+    while((hwlib::now_us() - start) < 200000){
+        if(fifo_entries() >= 32){
+            amount = drain(samples, 33);
+            break;
+        }
+        hwlib::wait_us(period_us(data_rate::hz_400));
+    }
+    
+    write_bits(fifo_ctl::mode(static_cast<uint8_t>(fifo_mode::bypass)));
+    write_register(FIFO_CTL, saved_fifo);
+    write_register(BW_RATE, saved_rate);
+    write_register(DATA_FORMAT, saved_format);
+    write_register(POWER_CTL, saved_power);
+    
+    if(amount == 0){
+        set_offsets(saved_offsets);
+        return saved_offsets;
+    }
+    
+    int32_t sum[3] = {0, 0, 0};
+    for(size_t i = 0; i < amount; i++){
+        sum[0] += samples[i].x;
+        sum[1] += samples[i].y;
+        sum[2] += samples[i].z;
+    }
+    
+    // At +-2g with full resolution 1 g is 256.
+    int32_t expected[3] = {0, 0, 0};
+    uint8_t up_axis = 2 - (static_cast<uint8_t>(resting) / 2);
+    expected[up_axis] = (static_cast<uint8_t>(resting) % 2 == 0) ? 256 : -256;
+    
+    offsets measured;
+    measured.x = offset_steps(sum[0] / static_cast<int32_t>(amount), expected[0]);
+    measured.y = offset_steps(sum[1] / static_cast<int32_t>(amount), expected[1]);
+    measured.z = offset_steps(sum[2] / static_cast<int32_t>(amount), expected[2]);
+    set_offsets(measured);
+    return measured;
+}
+
+
+void ADXL345::write_data_rate(const uint8_t & code, const bool & low_power){
+    write_bits(bw_rate::rate(code) | bw_rate::low_power(low_power));
+    rate_code = code;
+}
+
+
+uint32_t ADXL345::sample_period_us(){
+    return period_us(static_cast<data_rate>(rate_code));
+}
+
+
+void ADXL345::write_data_format(const uint8_t & byte, const int32_t & multiplier, const uint8_t & shift){
+    write_register(DATA_FORMAT, byte);
+    format_multiplier = multiplier;
+    format_shift = shift;
+}
+
+
+milli_g ADXL345::to_milli_g(const int16_t & raw){
+    return milli_g::from_fixed((static_cast<int32_t>(raw) * format_multiplier) >> format_shift);
+}
+
+
+ADXL345::sample_mg ADXL345::read_sample_mg(){
+    auto data = read_sample();
+    sample_mg converted;
+    converted.x = to_milli_g(data.x);
+    converted.y = to_milli_g(data.y);
+    converted.z = to_milli_g(data.z);
+    return converted;
+}
+
+
+void ADXL345::write_register(const uint8_t & register_address, const uint8_t & data){
+    if(!is_shadowed(register_address)){
+        write(register_address, device_id, data);
+        return;
+    }
+    uint8_t index = register_address - THRESH_TAP;
+    if(batching){
+        pending[index] = data;
+        pending_mask |= (1UL << index);
+        return;
+    }
+    if(((shadow_valid >> index) & 1) && (shadow[index] == data)){
+        return;
+    }
+    write(register_address, device_id, data);
+    shadow[index] = data;
+    shadow_valid |= (1UL << index);
+}
+
+
+void ADXL345::write_registers(const uint8_t & register_address, const uint8_t data[], const size_t & n){
+    if(batching){
+        for(size_t i = 0; i < n; i++){
+            write_register(register_address + i, data[i]);
+        }
+        return;
+    }
+    bool changed = false;
+    for(size_t i = 0; i < n; i++){
+        uint8_t address = register_address + i;
+        uint8_t index = address - THRESH_TAP;
+        if(!is_shadowed(address) || !((shadow_valid >> index) & 1) || (shadow[index] != data[i])){
+            changed = true;
+        }
+    }
+    if(!changed){
+        return;
+    }
+    write(register_address, device_id, data, n);
+    for(size_t i = 0; i < n; i++){
+        uint8_t address = register_address + i;
+        if(is_shadowed(address)){
+            shadow[address - THRESH_TAP] = data[i];
+            shadow_valid |= (1UL << (address - THRESH_TAP));
+        }
+    }
+}
+
+
+uint8_t ADXL345::read_register(const uint8_t & register_address){
+    if(!is_shadowed(register_address)){
+        return read(register_address, device_id);
+    }
+    uint8_t index = register_address - THRESH_TAP;
+    if(batching && ((pending_mask >> index) & 1)){
+        return pending[index];
+    }
+    if(!((shadow_valid >> index) & 1)){
+        shadow[index] = read(register_address, device_id);
+        shadow_valid |= (1UL << index);
+    }
+    return shadow[index];
+}
+
+
+void ADXL345::update_register(const uint8_t & register_address, const uint8_t & mask, const uint8_t & data){
+    uint8_t old_byte = read_register(register_address);
+    write_register(register_address, (old_byte & ~mask) | (data & mask));
+}
+
+
+void ADXL345::begin_batch(){
+    batching = true;
+    pending_mask = 0;
+}
+
+
+size_t ADXL345::apply_batch(){
+    batching = false;
+    uint32_t changed = 0;
+    for(uint8_t i = 0; i < sizeof(shadow); i++){
+        if(((pending_mask >> i) & 1) && (!((shadow_valid >> i) & 1) || (shadow[i] != pending[i]))){
+            changed |= (1UL << i);
+        }
+    }
+    pending_mask = 0;
+    
+    size_t bursts = 0;
+    uint8_t first = 0;
+    while(first < sizeof(shadow)){
+        if(!((changed >> first) & 1)){
+            first++;
+            continue;
+        }
+        // Grow the burst up to the last changed register that can be reached over gaps of at most 2 known registers.
+        uint8_t end = first + 1;
+        for(uint8_t next = end; next < sizeof(shadow); next++){
+            if((changed >> next) & 1){
+                end = next + 1;
+            } else if(((next - end) >= 2) || !((shadow_valid >> next) & 1)){
+                break;
+            }
+        }
+        uint8_t bytes[sizeof(shadow)];
+        for(uint8_t i = first; i < end; i++){
+            bytes[i - first] = ((changed >> i) & 1) ? pending[i] : shadow[i];
+        }
+        write(THRESH_TAP + first, device_id, bytes, end - first);
+        for(uint8_t i = first; i < end; i++){
+            shadow[i] = bytes[i - first];
+            shadow_valid |= (1UL << i);
+        }
+        bursts++;
+        first = end;
+    }
+    return bursts;
+}
+
+
+void ADXL345::resync(){
+    uint8_t index = 0;
+    while(index < sizeof(shadow)){
+        if(!((shadowed_registers >> index) & 1)){
+            index++;
+            continue;
+        }
+        uint8_t length = 0;
+        while((index + length < sizeof(shadow)) && ((shadowed_registers >> (index + length)) & 1)){
+            length++;
+        }
+        read(THRESH_TAP + index, device_id, &shadow[index], length);
+        index += length;
+    }
+    shadow_valid = shadowed_registers;
+}
@@ -11,6 +11,8 @@
 
 #include "hwlib.hpp"
 #include "i2c_ipass.hpp"
+#include "milli_g.hpp"
+#include "registers.hpp"
 
 class ADXL345 : public i2c_ipass {
 private:
@@ -19,22 +21,159 @@ private:
     int y_offset;
     int z_offset;
     bool start_in_measure_mode;
+    uint8_t rate_code = 0x0A;
+    int32_t format_multiplier = 4000;
+    uint8_t format_shift = 2;
+    uint8_t shadow[28];
+    uint32_t shadow_valid = 0;
+    uint8_t pending[28];
+    uint32_t pending_mask = 0;
+    bool batching = false;
+    
+    int convert_2g(const int16_t & raw);
+    void write_data_rate(const uint8_t & code, const bool & low_power);
+    void write_data_format(const uint8_t & byte, const int32_t & multiplier, const uint8_t & shift);
+    
+    // The shadow copy functions on a plain address, the public ones take a register_descriptor so a read only register doesn't compile.
+    void write_register(const uint8_t & register_address, const uint8_t & data);
+    void write_registers(const uint8_t & register_address, const uint8_t data[], const size_t & n);
+    void update_register(const uint8_t & register_address, const uint8_t & mask, const uint8_t & data);
     
 public:
 
+    /// \brief
+    /// One reading of all 3 axis taken from the same conversion.
+    /// \details
+    /// The values are the raw register values, so they still need to be converted.
+    struct sample {
+        int16_t x;
+        int16_t y;
+        int16_t z;
+    };
+    
+    /// \brief
+    /// One reading of all 3 axis converted to milli-g.
+    struct sample_mg {
+        milli_g x;
+        milli_g y;
+        milli_g z;
+    };
+    
+    /// \brief
+    /// The 4 modes of the FIFO_CTL register.
+    /// \details
+    /// bypass: the FIFO is not used and the data registers always hold the newest conversion.
+    /// fifo: the FIFO collects up to 32 samples and then stops collecting until it has been read.
+    /// stream: the FIFO collects the newest 32 samples and throws away the oldest when it's full.
+    /// trigger: the FIFO works like stream mode until a trigger event and then keeps the samples around that event.
+    enum class fifo_mode : uint8_t {
+        bypass = 0,
+        fifo = 1,
+        stream = 2,
+        trigger = 3
+    };
+    
+    /// \brief
+    /// The bits of the INT_ENABLE, INT_MAP and INT_SOURCE registers.
+    /// \details
+    /// They can be combined with | to enable, map or check more than one interrupt at once.
+    /// Example: ADXL345::data_ready | ADXL345::watermark
+    enum interrupt : uint8_t {
+        overrun = 0x01,
+        watermark = 0x02,
+        free_fall = 0x04,
+        inactivity = 0x08,
+        activity = 0x10,
+        double_tap = 0x20,
+        single_tap = 0x40,
+        data_ready = 0x80
+    };
+    
+    /// \brief
+    /// The output data rates of the BW_RATE register.
+    /// \details
+    /// Every step doubles the rate, from 0.10 Hz up to 3200 Hz.
+    /// The names round the rate to 2 decimals, hz_0_39 for example is really 0.390625 Hz.
+    /// Keep in mind that the datasheet only recommends 800 Hz and up with a bus of at least 400 kHz.
+    enum class data_rate : uint8_t {
+        hz_0_10 = 0x0,
+        hz_0_20 = 0x1,
+        hz_0_39 = 0x2,
+        hz_0_78 = 0x3,
+        hz_1_56 = 0x4,
+        hz_3_13 = 0x5,
+        hz_6_25 = 0x6,
+        hz_12_5 = 0x7,
+        hz_25 = 0x8,
+        hz_50 = 0x9,
+        hz_100 = 0xA,
+        hz_200 = 0xB,
+        hz_400 = 0xC,
+        hz_800 = 0xD,
+        hz_1600 = 0xE,
+        hz_3200 = 0xF
+    };
+    
+    /// \brief
+    /// Returns the time between 2 samples at the given data rate in microseconds.
+    /// \details
+    /// Example: uint32_t period = ADXL345::period_us(ADXL345::data_rate::hz_100); // 10000
+    ///
+    /// The rates are 3200 Hz divided by a power of 2, so the period is 312.5 us times that power of 2.
+    /// Only 3200 Hz doesn't come out even, it is rounded down to 312 us.
+    static constexpr uint32_t period_us(const data_rate & rate){
+        return (625UL << (15 - static_cast<uint8_t>(rate))) / 2;
+    }
+
+    /// \brief
+    /// The values of the OFSX, OFSY and OFSZ registers.
+    /// \details
+    /// Every step is 15.6 mg and is added to the measured acceleration of that axis.
+    struct offsets {
+        int8_t x = 0;
+        int8_t y = 0;
+        int8_t z = 0;
+    };
+    
+    /// \brief
+    /// Which axis points up while the sensor lies still during calibrate.
+    /// \details
+    /// The axis that points up should measure +1 g and the axis that points down -1 g, the other 2 axis should measure 0.
+    enum class orientation : uint8_t {
+        z_up,
+        z_down,
+        y_up,
+        y_down,
+        x_up,
+        x_down
+    };
+    
     /// \brief
     /// This is the constructor for an ADXL345 object
     /// \details
-    /// Example: ADXL345 accelerometer(i2c_bus, 0x53, -5, 4, 8, 1);
+    /// Example: ADXL345 accelerometer(i2c_bus, 0x53, -5, 4, 8);
     ///
-    /// The first variable is an hwlib::i2c_bus_bit_banged_scl_sda object.
+    /// The first variable is the i2c_backend the sensor is connected to.
     /// The second variable is the uint8_t device_id of the sensor
     /// The third variable is an int for the x_offset register
     /// The fourth variable is an int for the y_offset register
     /// The fifth variable is an int for the z_offset register
     /// Those variables are used to calibrate the sensor in the setup function
-    ADXL345(const hwlib::i2c_bus_bit_banged_scl_sda & i2c_bus, const uint8_t & device_id, const int & x_offset, const int & y_offset, const int & z_offset);
+    ADXL345(i2c_backend & i2c_bus, const uint8_t & device_id, const int & x_offset, const int & y_offset, const int & z_offset);
+    
     
+    /// \brief
+    /// Returns the device id (i2c address) of the sensor.
+    uint8_t get_device_id();
+    
+    /// \brief
+    /// Checks if there is an ADXL345 answering at the device id.
+    /// \details
+    /// Example: if(ADXL345_object.is_connected()){ ... }
+    ///
+    /// It reads the DEVID register, which always holds 0xE5 on an ADXL345.
+    /// When nothing answers the pull ups make the bus read 0xFF, so that can't be mistaken for a sensor.
+    bool is_connected();
     
     /// \brief
     /// This function writes the offset data to the offset registers and can put the sensor in measure mode base on the start_in_measure_mode varible.
@@ -44,15 +183,16 @@ public:
     /// The offset variable and the start_in_measure_mode are stored inside the object itsels so there is no need to give them to the function as variable.
     /// It writes the offset variable to the correct register so that the sensor is calibrated correctly whenever this function is called.
     /// And if set_in_measure_mode is true it also executes the set_measuring_mode function to put the device straight into measure mode.
+    /// The writes go through the shadow copy, so registers that already hold the right value are skipped.
     void setup(const bool & start_in_measure_mode);
     
     /// \brief
-    /// This function wrytes a byte(00001000) to the POWER_CTL register to put the sensor in measure mode by making bit D3 high.
+    /// This function puts the sensor in measure mode by setting bit D3 in the POWER_CTL register.
     /// \details
     /// Example: ADXL345_object.set_measuring_mode();
     ///
     /// There is no need to give it any variable since this function will always turn on the same bit in the same register.
-    /// You can also skip this function and use the i2c_ipass write directly by using i2c_ipass.write(POWER_CTL, device_id, 8);
+    /// The other bits of POWER_CTL are left alone, they come from the shadow copy so this is only a single write.
     void set_measuring_mode();
     
     /// \brief
@@ -63,10 +203,130 @@ public:
     /// It requires no variable since it always clears the same bit.
     ///
     /// This function only wants to set bit D3 low
-    /// So in order to not touch any of the other bits it reads the current data from the register.
-    /// It then ands that with 11110111 ensuring that the that aren't D3 and are set stay set.
+    /// So in order to not touch any of the other bits it takes the current value of the register from the shadow copy.
+    /// It then ands that with 11110111 ensuring that the that aren't D3 and are set stay set, and writes that back in a single write.
     void set_standby_mode();
     
+    /// \brief
+    /// Writes a register through the shadow copy.
+    /// \details
+    /// Example: ADXL345_object.write_register(OFSX, 5);
+    ///
+    /// The ADXL345 object keeps a copy of every control register from THRESH_TAP up to FIFO_CTL that it has written or read.
+    /// When the copy of the register already holds the same byte the write is skipped, so writing a setting that is already there costs nothing.
+    /// Registers that the sensor changes by itself (ACT_TAP_STATUS, INT_SOURCE and the data registers) have no copy and are always written.
+    /// Writes with the i2c_ipass write function go around the copy, call resync after doing that.
+    /// A read only register doesn't compile.
+    template< uint8_t Address, register_access Access, uint8_t Width >
+    void write_register(const register_descriptor< Address, Access, Width > &, const uint8_t & data){
+        static_assert(Access != register_access::read_only, "this register can only be read");
+        write_register(Address, data);
+    }
+    
+    /// \brief
+    /// Writes n consecutive registers in one burst through the shadow copy.
+    /// \details
+    /// Example: const uint8_t offsets[3] = {2, 254, 5};
+    /// Example: ADXL345_object.write_registers(OFSX, offsets, 3);
+    ///
+    /// When every register already holds its byte in the shadow copy nothing is written.
+    /// Otherwise all n bytes are written with one i2c_ipass burst write and the shadow copy is updated.
+    /// A read only start register doesn't compile.
+    template< uint8_t Address, register_access Access, uint8_t Width >
+    void write_registers(const register_descriptor< Address, Access, Width > &, const uint8_t data[], const size_t & n){
+        static_assert(Access != register_access::read_only, "this register can only be read");
+        write_registers(Address, data, n);
+    }
+    
+    /// \brief
+    /// Reads a register through the shadow copy.
+    /// \details
+    /// Example: uint8_t power = ADXL345_object.read_register(POWER_CTL);
+    ///
+    /// When there is a copy of the register it is returned without using the bus.
+    /// Otherwise the register is read from the sensor, and kept when it is a control register.
+    uint8_t read_register(const uint8_t & register_address);
+    
+    /// \brief
+    /// Changes only the bits in mask of a register.
+    /// \details
+    /// Example: ADXL345_object.update_register(POWER_CTL, 0x08, 0x00);
+    ///
+    /// With register fields update_bits does the same without the magic numbers.
+    ///
+    /// The bits outside of mask keep the value from the shadow copy and the bits inside mask get the value from data.
+    /// Once the register has a copy this is one write, or nothing at all when the bits were already right.
+    /// A read only register doesn't compile.
+    template< uint8_t Address, register_access Access, uint8_t Width >
+    void update_register(const register_descriptor< Address, Access, Width > &, const uint8_t & mask, const uint8_t & data){
+        static_assert(Access != register_access::read_only, "this register can only be read");
+        update_register(Address, mask, data);
+    }
+    
+    /// \brief
+    /// Writes field values to their register, the bits of the register that no field sets are cleared.
+    /// \details
+    /// Example: ADXL345_object.write_bits(fifo_ctl::mode(2) | fifo_ctl::samples(16));
+    ///
+    /// The byte is put together at compile time when the values are constants, and a read only register doesn't compile.
+    /// It goes through write_register, so it uses the shadow copy and can be part of a batch.
+    template< typename R >
+    void write_bits(const register_bits< R > & bits){
+        static_assert(R::writable, "this register can only be read");
+        write_register(R::address, bits.value);
+    }
+    
+    /// \brief
+    /// Changes only the bits of the given fields of their register.
+    /// \details
+    /// Example: ADXL345_object.update_bits(power_ctl::measure(1));
+    ///
+    /// Like update_register, but the mask comes from the fields so there are no magic numbers.
+    template< typename R >
+    void update_bits(const register_bits< R > & bits){
+        static_assert(R::writable, "this register can only be read");
+        update_register(R::address, bits.mask, bits.value);
+    }
+    
+    /// \brief
+    /// Returns the value of a field, read through the shadow copy when its register has one.
+    /// \details
+    /// Example: uint8_t watermark = ADXL345_object.read_field(fifo_ctl::samples);
+    template< typename R, uint8_t Shift, uint8_t Bits >
+    uint8_t read_field(const register_field< R, Shift, Bits > & field){
+        return field.get(read_register(R::address));
+    }
+    
+    /// \brief
+    /// Reads all control registers from the sensor into the shadow copy.
+    /// \details
+    /// Example: ADXL345_object.resync();
+    ///
+    /// This is needed when something else changed the registers, like a write with the i2c_ipass write function or a power cycle of the sensor.
+    /// The registers are read in 4 bursts, skipping the registers that change when they are read.
+    void resync();
+    
+    /// \brief
+    /// Starts collecting register writes instead of sending them.
+    /// \details
+    /// Example: ADXL345_object.begin_batch();
+    ///
+    /// Until apply_batch every write to a control register, also the ones from functions like set_tap_detection or set_data_rate, is only remembered.
+    /// read_register and update_register see the remembered bytes, so settings that share a register still combine.
+    /// Registers without a shadow copy are still written right away.
+    /// Don't call calibrate in a batch, it needs its writes to reach the sensor.
+    void begin_batch();
+    
+    /// \brief
+    /// Writes everything collected since begin_batch in as few bursts as possible and returns the amount of bursts.
+    /// \details
+    /// Example: size_t transactions = ADXL345_object.apply_batch();
+    ///
+    /// Registers that already hold their byte are left out, and registers that follow each other are written in one auto increment burst.
+    /// A gap of up to 2 registers with a known value is written along with its old value, that costs less than starting a new transaction.
+    /// The bursts go from low to high addresses, so POWER_CTL is written after BW_RATE and before the interrupt, format and FIFO registers.
+    size_t apply_batch();
+    
     /// \brief
     /// The data for the axis are stored in 2 registers, this function reads both and returns that data.
     /// \details
@@ -75,6 +335,7 @@ public:
     /// Since the data for the axis are stored in 2 registers the function requires them both as variable.
     /// Both are const uint8_t variable.
     /// It returns an int16-t variable which contains the combined data from the 2 registers.
+    /// When the second register directly follows the first, which is the case for all axis, both bytes are read in one burst so they can't come from different conversions.
     int16_t read_axis_raw(const uint8_t & axis_register_address_1, const uint8_t & axis_register_address_2);
     
     /// \brief
@@ -85,6 +346,7 @@ public:
     /// It returns an intvariable which contains the combined data from the 2 registers but is also converted to -+2g.
     /// 
     /// Hwlib cannot print floats therefore the data has been multiplied with 100 so that instead of -1.00 to 1.00 we have -100 to 100.
+    /// This scale is only right for the power up data format, read_sample_mg works for all of them.
     int read_axis_2g(const uint8_t & axis_register_address_1, const uint8_t & axis_register_address_2);
     
     /// \brief
@@ -95,8 +357,250 @@ public:
     ///
     /// This function requires an int array that is 3 long.
     /// It reads the 3 axis data and puts it in the array and returns that array.
-    /// Do keep in mind that this function uses the read_axis_2g function and not the raw data version.
+    /// The 3 axis are read with one read_sample call so they all come from the same conversion.
     int* read_all_axis_2g(int axis_data[3]);
+    
+    /// \brief
+    /// This function reads DATAX0 up to DATAZ1 in one burst and returns the raw data of all 3 axis.
+    /// \details
+    /// Example: ADXL345::sample data = ADXL345_object.read_sample();
+    ///
+    /// The sensor keeps the 6 data registers stable during a multi-byte read, so the low and high bytes of every axis are guaranteed to belong together.
+    /// This costs 2 bus transactions where reading every register seperately costs 12.
+    sample read_sample();
+    
+    /// \brief
+    /// This function writes the FIFO_CTL register to choose the FIFO mode and the watermark.
+    /// \details
+    /// Example: ADXL345_object.set_fifo_mode(ADXL345::fifo_mode::stream, 16);
+    ///
+    /// The watermark is the amount of entries at which the watermark interrupt goes off, it only has 5 bits so it is limited to 31.
+    /// In trigger mode the watermark is the amount of samples kept from before the trigger event.
+    /// trigger_on_int2 decides which interrupt pin is used as trigger in trigger mode, by default it's INT1.
+    void set_fifo_mode(const fifo_mode & mode, const uint8_t & watermark, const bool & trigger_on_int2 = false);
+    
+    /// \brief
+    /// This function returns the amount of samples that are waiting in the FIFO.
+    /// \details
+    /// Example: uint8_t waiting = ADXL345_object.fifo_entries();
+    ///
+    /// It reads the entries bits of the FIFO_STATUS register, which can be up to 33 because the output registers also hold a sample.
+    uint8_t fifo_entries();
+    
+    /// \brief
+    /// This function reads every sample that is waiting in the FIFO.
+    /// \details
+    /// Example: ADXL345::sample samples[33];
+    /// Example: size_t amount = ADXL345_object.drain(samples, 33);
+    ///
+    /// It reads FIFO_STATUS once and then pops every entry with a back to back read_sample burst, oldest sample first.
+    /// Never more than n samples are read so the array must be at least n long, samples that don't fit stay in the FIFO.
+    /// It returns the amount of samples that have been put in the array.
+    size_t drain(sample samples[], const size_t & n);
+    
+    /// \brief
+    /// This function enables interrupts and decides on which pin they come out.
+    /// \details
+    /// Example: ADXL345_object.set_interrupts(ADXL345::data_ready | ADXL345::watermark, ADXL345::watermark);
+    ///
+    /// The first variable holds the interrupt bits that should be enabled, all other interrupts are disabled.
+    /// The second variable holds the interrupt bits that go to INT2, all other interrupts go to INT1.
+    /// INT_MAP is written before INT_ENABLE so an interrupt never shows up on the wrong pin.
+    /// The pins are active high unless INT_INVERT is set in DATA_FORMAT.
+    void set_interrupts(const uint8_t & enabled, const uint8_t & on_int2 = 0);
+    
+    /// \brief
+    /// This function reads and returns the INT_SOURCE register.
+    /// \details
+    /// Example: uint8_t source = ADXL345_object.read_interrupt_source();
+    ///
+    /// Reading INT_SOURCE acknowledges the tap, activity, inactivity and free fall interrupts.
+    /// The data_ready, watermark and overrun bits are cleared by reading the data instead.
+    uint8_t read_interrupt_source();
+    
+    /// \brief
+    /// This function only reads INT_SOURCE when the given interrupt pin is asserted.
+    /// \details
+    /// Example: if(ADXL345_object.poll_interrupt(int1) & ADXL345::watermark){ ... }
+    ///
+    /// When the pin is low there is nothing to do so the bus isn't touched at all and 0 is returned.
+    /// When the pin is high the source is read, acknowledged and returned in one single register read.
+    /// The pin can be any hwlib::pin_in, so a simulated pin can be used to test this without a sensor.
+    uint8_t poll_interrupt(hwlib::pin_in & int_pin);
+    
+    /// \brief
+    /// The axis bits of the TAP_AXES and ACT_TAP_STATUS registers.
+    /// \details
+    /// They can be combined with |, all_axis is all 3 of them.
+    enum axis : uint8_t {
+        axis_z = 0x01,
+        axis_y = 0x02,
+        axis_x = 0x04,
+        all_axis = 0x07
+    };
+    
+    /// \brief
+    /// Settings for the tap and double tap detection of the sensor.
+    /// \details
+    /// threshold: how hard a tap has to be, in steps of 62.5 mg.
+    /// duration_us: how long a tap may stay above the threshold, in steps of 625 us.
+    /// latency_us: how long after a tap the second tap of a double tap may start, in steps of 1.25 ms.
+    /// window_us: how long after the latency the second tap has to happen, in steps of 1.25 ms.
+    /// axes: the axis that take part in detecting taps.
+    /// suppress: a double tap doesn't count when the acceleration is still above the threshold during the latency.
+    ///
+    /// The defaults detect a firm tap on the table and a double tap within a third of a second.
+    /// A window of 0 turns double tap detection off.
+    struct tap_config {
+        milli_g threshold = milli_g(3000);
+        uint32_t duration_us = 10000;
+        uint32_t latency_us = 20000;
+        uint32_t window_us = 300000;
+        uint8_t axes = all_axis;
+        bool suppress = false;
+    };
+    
+    /// \brief
+    /// This function writes THRESH_TAP, DUR, LATENT, WINDOW and TAP_AXES to set up tap detection.
+    /// \details
+    /// Example: ADXL345_object.set_tap_detection(ADXL345::tap_config());
+    ///
+    /// THRESH_TAP up to WINDOW are written in one burst, the offset registers between them get their value from the shadow copy.
+    /// TAP_AXES is a separate write, unless it already holds the right value.
+    /// The values are rounded down to the steps of the registers and limited to 255 steps.
+    /// The detection only reaches the pins once single_tap or double_tap is enabled with set_interrupts.
+    /// The sensor detects taps at its data rate, so use at least 100 Hz.
+    void set_tap_detection(const tap_config & config);
+    
+    /// \brief
+    /// This function writes THRESH_ACT and the activity half of ACT_INACT_CTL to set up activity detection.
+    /// \details
+    /// Example: ADXL345_object.set_activity_detection(milli_g(1500));
+    ///
+    /// The threshold is in steps of 62.5 mg.
+    /// With ac_coupled the threshold is compared with the change since detection was turned on instead of with the acceleration itself, so gravity doesn't count.
+    /// The inactivity half of ACT_INACT_CTL is left alone.
+    void set_activity_detection(const milli_g & threshold, const uint8_t & axes = all_axis, const bool & ac_coupled = true);
+    
+    /// \brief
+    /// This function reads ACT_TAP_STATUS, which tells on which axis the last tap or activity happened.
+    /// \details
+    /// Example: if(ADXL345_object.read_tap_status() & ADXL345::axis_z){ ... }
+    ///
+    /// The tap axis are in the low bits (see axis), the activity axis are the same bits shifted 4 to the left.
+    uint8_t read_tap_status();
+    
+    /// \brief
+    /// This function writes the 3 offset registers in one burst and remembers them for setup.
+    /// \details
+    /// Example: ADXL345_object.set_offsets(offsets);
+    void set_offsets(const offsets & new_offsets);
+    
+    /// \brief
+    /// Returns the offsets that setup writes, which are the ones from the constructor until calibrate or set_offsets changes them.
+    offsets get_offsets();
+    
+    /// \brief
+    /// This function measures the offsets of the sensor while it lies still and writes them.
+    /// \details
+    /// Example: ADXL345::offsets measured = ADXL345_object.calibrate();
+    ///
+    /// The sensor has to lie still with the given axis pointing up.
+    /// The offset registers are cleared and the FIFO collects 32 samples at 400 Hz with full resolution, which takes about 80 ms.
+    /// The average of those samples is compared with what the orientation should measure, and the difference is turned into offset register steps of 15.6 mg.
+    /// Those are written in one burst and returned, so they can be stored and given to the constructor or set_offsets next time without calibrating again.
+    ///
+    /// Afterwards BW_RATE, DATA_FORMAT, FIFO_CTL and POWER_CTL are put back the way they were, so any samples that were in the FIFO are gone.
+    /// When the FIFO doesn't fill up within 200 ms (no sensor or no power) the offsets are left the way they were and returned unchanged.
+    offsets calibrate(const orientation & resting = orientation::z_up);
+    
+    /// \brief
+    /// This function writes the BW_RATE register to choose the output data rate and the low power mode.
+    /// \details
+    /// Example: ADXL345_object.set_data_rate< ADXL345::data_rate::hz_400 >();
+    /// Example: ADXL345_object.set_data_rate< ADXL345::data_rate::hz_25, true >();
+    ///
+    /// Both are template parameters so that a combination the sensor can't do is a compile error.
+    /// Low power mode only exists from 12.5 Hz up to 400 Hz, so low power with any other rate won't compile.
+    /// Low power mode uses less current but gives a bit more noise.
+    /// After power up the sensor runs at 100 Hz without low power.
+    template< data_rate rate, bool low_power = false >
+    void set_data_rate(){
+        static_assert(
+            !low_power || ((rate >= data_rate::hz_12_5) && (rate <= data_rate::hz_400)),
+            "the ADXL345 only has a low power mode from 12.5 Hz up to 400 Hz"
+        );
+        write_data_rate(static_cast<uint8_t>(rate), low_power);
+    }
+    
+    /// \brief
+    /// Returns the time between 2 samples at the data rate that was last set in microseconds.
+    /// \details
+    /// Example: size_t samples_per_frame = frame_time_us / ADXL345_object.sample_period_us();
+    ///
+    /// This can be used to decide how big a buffer or FIFO watermark has to be to hold everything that is sampled between 2 reads.
+    uint32_t sample_period_us();
+    
+    /// \brief
+    /// The measuring ranges of the DATA_FORMAT register.
+    enum class range : uint8_t {
+        g2 = 0,
+        g4 = 1,
+        g8 = 2,
+        g16 = 3
+    };
+    
+    /// \brief
+    /// A complete DATA_FORMAT configuration with its scale factor worked out at compile time.
+    /// \details
+    /// Example: using format = ADXL345::data_format< ADXL345::range::g16, true >;
+    ///
+    /// R is the measuring range.
+    /// full_resolution makes the resolution grow with the range so it stays 3.9 mg per bit, without it there are always 10 bits.
+    /// left_justify puts the most significant bit of the data in bit 15 instead of sign extending it.
+    ///
+    /// The range is 2 * g * 1000 mg wide and spread over 2 to the power resolution_bits steps.
+    /// So converting comes down to one multiply and one shift, and because everything is constexpr no branching is needed for that at runtime.
+    template< range R, bool full_resolution = false, bool left_justify = false >
+    struct data_format {
+        static constexpr uint8_t register_value = (::data_format::range(static_cast<uint8_t>(R)) | ::data_format::justify(left_justify) | ::data_format::full_res(full_resolution)).value;
+        static constexpr int32_t multiplier = 4000 << static_cast<uint8_t>(R);
+        static constexpr uint8_t resolution_bits = left_justify ? 16 : (full_resolution ? 10 + static_cast<uint8_t>(R) : 10);
+        static constexpr uint8_t shift = resolution_bits - milli_g::fraction_bits;
+        
+        static constexpr milli_g convert(const int16_t & raw){
+            return milli_g::from_fixed((static_cast<int32_t>(raw) * multiplier) >> shift);
+        }
+    };
+    
+    /// \brief
+    /// This function writes the DATA_FORMAT register and remembers the scale factor that belongs to it.
+    /// \details
+    /// Example: ADXL345_object.set_data_format< ADXL345::data_format< ADXL345::range::g8, true > >();
+    ///
+    /// The self test, SPI and INT_INVERT bits are cleared.
+    /// After power up the sensor uses data_format< range::g2 >.
+    template< typename format >
+    void set_data_format(){
+        write_data_format(format::register_value, format::multiplier, format::shift);
+    }
+    
+    /// \brief
+    /// Converts a raw axis value to milli-g with the scale factor of the data format that was last set.
+    /// \details
+    /// Example: milli_g y = ADXL345_object.to_milli_g(samples[0].y);
+    ///
+    /// This is one multiply and one shift.
+    /// When the format is known at compile time data_format<...>::convert can be used instead.
+    milli_g to_milli_g(const int16_t & raw);
+    
+    /// \brief
+    /// This function reads all 3 axis in one burst and returns them in milli-g.
+    /// \details
+    /// Example: ADXL345::sample_mg data = ADXL345_object.read_sample_mg();
+    ///
+    /// Unlike read_all_axis_2g this works with every range and resolution.
+    sample_mg read_sample_mg();
 };
 
 #endif
@@ -0,0 +1,99 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef ADXL345_GESTURES_HPP
+#define ADXL345_GESTURES_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "ADXL345.hpp"
+#include "ring_buffer.hpp"
+
+/// \brief
+/// One gesture the sensor detected.
+/// \details
+/// type is one of the gesture bits of ADXL345::interrupt: single_tap, double_tap, activity, inactivity or free_fall.
+/// axes is ACT_TAP_STATUS at the time the event was handled, for taps and activity it tells which axis were involved.
+/// time_us is hwlib::now_us() when the event was handled.
+struct gesture_event {
+    uint_fast64_t time_us = 0;
+    ADXL345::interrupt type = ADXL345::single_tap;
+    uint8_t axes = 0;
+};
+
+/// \brief
+/// Queue of the gestures one or more ADXL345 sensors detected.
+/// \details
+/// Example: gesture_queue< 8 > gestures;
+/// Example: gestures.poll(accelerometer, int1);
+/// Example: gesture_event event; while(gestures.pop(event)){ ... }
+///
+/// The sensor does the detecting, this only turns the bits of INT_SOURCE into events so the application doesn't have to poll buttons or wait for them.
+/// Reading INT_SOURCE acknowledges the gesture interrupts, so when INT_SOURCE is also needed for something else (like the watermark) read it once and give it to handle.
+/// A double tap also sets single_tap for its first tap, when both are in the same read the single_tap event comes first.
+/// Events that don't fit in the queue are dropped.
+template< size_t N >
+class gesture_queue {
+private:
+    ring_buffer< gesture_event, N > events;
+    
+    static constexpr ADXL345::interrupt gestures[] = {
+        ADXL345::single_tap, 
+        ADXL345::double_tap, 
+        ADXL345::activity, 
+        ADXL345::inactivity, 
+        ADXL345::free_fall
+    };
+
+public:
+
+    /// \brief
+    /// Adds an event for every gesture bit in source, returns how many were added.
+    /// \details
+    /// ACT_TAP_STATUS is only read when source holds a tap or activity bit.
+    size_t handle(ADXL345 & sensor, const uint8_t & source){
+        uint8_t axes = 0;
+        if(source & (ADXL345::single_tap | ADXL345::double_tap | ADXL345::activity)){
+            axes = sensor.read_tap_status();
+        }
+        size_t added = 0;
+        for(const auto & gesture : gestures){
+            if(source & gesture){
+                gesture_event event;
+                event.time_us = hwlib::now_us();
+                event.type = gesture;
+                event.axes = axes;
+                added += events.push(event);
+            }
+        }
+        return added;
+    }
+    
+    /// \brief
+    /// Reads INT_SOURCE only when the interrupt pin is asserted and adds the gestures in it.
+    /// \details
+    /// Returns the INT_SOURCE that was read, or 0 when the pin was low, so the other bits can still be used.
+    uint8_t poll(ADXL345 & sensor, hwlib::pin_in & int_pin){
+        uint8_t source = sensor.poll_interrupt(int_pin);
+        handle(sensor, source);
+        return source;
+    }
+    
+    /// \brief
+    /// Takes the oldest event, returns false when there is none.
+    bool pop(gesture_event & event){
+        return events.pop(event);
+    }
+    
+    bool empty() const {
+        return events.empty();
+    }
+};
+
+template< size_t N >
+constexpr ADXL345::interrupt gesture_queue< N >::gestures[];
+
+#endif
@@ -0,0 +1,164 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef ADXL345_SAMPLER_HPP
+#define ADXL345_SAMPLER_HPP
+
+/// @file
+
+#include <array>
+#include "hwlib.hpp"
+#include "ADXL345.hpp"
+
+/// \brief
+/// Something that delivers the FIFO samples of N sensors, like an ADXL345_sampler or a replay_source.
+/// \details
+/// Example: void read_input(sample_source< 2 > & source){ source.drain(data); }
+///
+/// Code that only drains through this interface works the same on live sensors and on a recording.
+template< size_t N >
+class sample_source {
+public:
+
+    virtual ~sample_source() = default;
+
+    /// \brief
+    /// Everything that was waiting in the FIFO of every sensor.
+    /// \details
+    /// time_us is when the samples were collected, for an ADXL345_sampler that is hwlib::now_us() at the start of the bus window.
+    /// samples[d][amounts[d] - 1] is the newest sample of sensor d.
+    /// The sample before that was taken one sample period earlier, so the time of every sample can be worked out from time_us and ADXL345::sample_period_us.
+    struct fifo_frame {
+        uint_fast64_t time_us = 0;
+        uint_fast64_t window_us = 0;
+        std::array< size_t, N > amounts = {};
+        ADXL345::sample samples[N][33];
+    };
+
+    /// \brief
+    /// Fills result with the samples that arrived since the last drain.
+    virtual void drain(fifo_frame & result) = 0;
+};
+
+
+/// \brief
+/// Reads N ADXL345 sensors on the same bus as one group.
+/// \details
+/// Example: ADXL345_sampler< 2 > sensors({ &accelerometer, &accelerometer2 });
+/// Example: sensors.discover();
+/// Example: auto data = sensors.read();
+///
+/// All sensors are read right after each other with burst reads, so the bus is used in one window without other traffic in between.
+/// The result is a frame with one timestamp that holds the data of every sensor.
+/// Sensors that didn't answer during discover are skipped, their data stays 0.
+template< size_t N >
+class ADXL345_sampler : public sample_source< N > {
+private:
+    std::array< ADXL345 *, N > devices;
+    std::array< bool, N > present;
+
+public:
+
+    /// \brief
+    /// One sample of every sensor.
+    /// \details
+    /// time_us is hwlib::now_us() at the start of the bus window and window_us is how long reading all sensors took.
+    struct frame {
+        uint_fast64_t time_us = 0;
+        uint_fast64_t window_us = 0;
+        std::array< ADXL345::sample, N > samples = {};
+    };
+    
+    /// Everything that was waiting in the FIFO of every sensor, see sample_source.
+    using fifo_frame = typename sample_source< N >::fifo_frame;
+
+    /// \brief
+    /// Constructor for an ADXL345_sampler.
+    /// \details
+    /// The sensors are kept by pointer so they have to live at least as long as the sampler.
+    /// Until discover is called every sensor is expected to be there.
+    ADXL345_sampler(const std::array< ADXL345 *, N > & devices):
+        devices(devices)
+    {
+        present.fill(true);
+    }
+    
+    /// \brief
+    /// Checks which of the given sensors answer on their address and returns how many do.
+    /// \details
+    /// Example: if(sensors.discover() < 2){ hwlib::cout << "sensor missing" << hwlib::endl; }
+    ///
+    /// Only the addresses of the sensors given to the constructor are tried, the bus isn't scanned for other devices.
+    /// Every sensor is checked with ADXL345::is_connected.
+    /// Sensors that don't answer are skipped by read and drain from then on.
+    size_t discover(){
+        size_t found = 0;
+        for(size_t i = 0; i < N; i++){
+            present[i] = devices[i]->is_connected();
+            if(present[i]){
+                found++;
+            }
+        }
+        return found;
+    }
+    
+    /// \brief
+    /// Returns true when sensor i answered during the last discover.
+    bool is_present(const size_t & i){
+        return present[i];
+    }
+    
+    /// \brief
+    /// Returns the device id of every sensor that answered during the last discover.
+    /// \details
+    /// The ids are put at the start of the array, the amount of ids is returned.
+    size_t addresses(std::array< uint8_t, N > & ids){
+        size_t found = 0;
+        for(size_t i = 0; i < N; i++){
+            if(present[i]){
+                ids[found] = devices[i]->get_device_id();
+                found++;
+            }
+        }
+        return found;
+    }
+    
+    /// \brief
+    /// Reads the newest sample of every sensor.
+    /// \details
+    /// Every sensor costs one read_sample burst of 2 transactions.
+    frame read(){
+        frame result;
+        result.time_us = hwlib::now_us();
+        for(size_t i = 0; i < N; i++){
+            if(present[i]){
+                result.samples[i] = devices[i]->read_sample();
+            }
+        }
+        result.window_us = hwlib::now_us() - result.time_us;
+        return result;
+    }
+    
+    /// \brief
+    /// Drains the FIFO of every sensor into the given fifo_frame.
+    /// \details
+    /// Example: ADXL345_sampler< 2 >::fifo_frame data;
+    /// Example: sensors.drain(data);
+    ///
+    /// The sensors have to be in a FIFO mode, see ADXL345::set_fifo_mode.
+    /// The fifo_frame is big, so it is filled in place instead of returned.
+    void drain(fifo_frame & result) override {
+        result.time_us = hwlib::now_us();
+        for(size_t i = 0; i < N; i++){
+            result.amounts[i] = 0;
+            if(present[i]){
+                result.amounts[i] = devices[i]->drain(result.samples[i], 33);
+            }
+        }
+        result.window_us = hwlib::now_us() - result.time_us;
+    }
+};
+
+#endif
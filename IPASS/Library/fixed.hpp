@@ -0,0 +1,152 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FIXED_HPP
+#define FIXED_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+
+/// \brief
+/// Fixed point number for positions and speeds in pixels.
+/// \details
+/// Example: fixed speed = fixed(3) / 2; // 1.5 pixels per step
+///
+/// The value is stored as an int32_t with 8 fraction bits (Q24.8), so the smallest step is 1/256 pixel.
+/// That gives smooth motion at any speed without floating point, which the Due doesn't have in hardware.
+/// All arithmetic is constexpr.
+class fixed {
+private:
+    int32_t value;
+
+public:
+
+    /// \brief
+    /// The amount of fraction bits in the stored value.
+    static constexpr int fraction_bits = 8;
+    
+    /// \brief
+    /// Constructor for a fixed from whole pixels.
+    /// \details
+    /// Example: fixed position(20);
+    constexpr explicit fixed(const int32_t & whole = 0):
+        value(whole * (1 << fraction_bits))
+    {}
+    
+    /// \brief
+    /// Creates a fixed from a value that already has fraction_bits fraction bits.
+    static constexpr fixed from_fixed(const int32_t & raw){
+        fixed result;
+        result.value = raw;
+        return result;
+    }
+    
+    /// \brief
+    /// Returns the stored value including the fraction bits.
+    constexpr int32_t raw() const {
+        return value;
+    }
+    
+    /// \brief
+    /// Returns the value rounded to whole pixels, halves round up.
+    constexpr int32_t whole() const {
+        return (value + (1 << (fraction_bits - 1))) >> fraction_bits;
+    }
+    
+    constexpr fixed operator+(const fixed & rhs) const {
+        return from_fixed(value + rhs.value);
+    }
+    
+    constexpr fixed operator-(const fixed & rhs) const {
+        return from_fixed(value - rhs.value);
+    }
+    
+    constexpr fixed operator-() const {
+        return from_fixed(-value);
+    }
+    
+    constexpr fixed operator*(const fixed & rhs) const {
+        return from_fixed((static_cast<int64_t>(value) * rhs.value) >> fraction_bits);
+    }
+    
+    constexpr fixed operator*(const int32_t & rhs) const {
+        return from_fixed(value * rhs);
+    }
+    
+    constexpr fixed operator/(const int32_t & rhs) const {
+        return from_fixed(value / rhs);
+    }
+    
+    fixed & operator+=(const fixed & rhs){
+        value += rhs.value;
+        return *this;
+    }
+    
+    constexpr bool operator==(const fixed & rhs) const {
+        return value == rhs.value;
+    }
+    
+    constexpr bool operator!=(const fixed & rhs) const {
+        return value != rhs.value;
+    }
+    
+    constexpr bool operator<(const fixed & rhs) const {
+        return value < rhs.value;
+    }
+    
+    constexpr bool operator>(const fixed & rhs) const {
+        return value > rhs.value;
+    }
+};
+
+/// \brief
+/// A position or speed in fixed point pixels.
+/// \details
+/// Example: fixed_xy speed(fixed(2), fixed(1) / 2);
+struct fixed_xy {
+    fixed x;
+    fixed y;
+    
+    constexpr fixed_xy(const fixed & x = fixed(), const fixed & y = fixed()):
+        x(x),
+        y(y)
+    {}
+    
+    /// \brief
+    /// Creates a fixed_xy from whole pixels.
+    fixed_xy(const hwlib::xy & whole):
+        x(whole.x),
+        y(whole.y)
+    {}
+    
+    constexpr fixed_xy operator+(const fixed_xy & rhs) const {
+        return fixed_xy(x + rhs.x, y + rhs.y);
+    }
+    
+    constexpr fixed_xy operator-(const fixed_xy & rhs) const {
+        return fixed_xy(x - rhs.x, y - rhs.y);
+    }
+    
+    constexpr fixed_xy operator*(const fixed & rhs) const {
+        return fixed_xy(x * rhs, y * rhs);
+    }
+    
+    constexpr bool operator==(const fixed_xy & rhs) const {
+        return (x == rhs.x) && (y == rhs.y);
+    }
+    
+    /// \brief
+    /// Returns the position rounded to whole pixels.
+    hwlib::xy rounded() const {
+        return hwlib::xy(x.whole(), y.whole());
+    }
+};
+
+inline hwlib::ostream & operator<<(hwlib::ostream & lhs, const fixed & rhs){
+    return lhs << rhs.whole();
+}
+
+#endif
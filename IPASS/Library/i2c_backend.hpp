@@ -0,0 +1,73 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef I2C_BACKEND_HPP
+#define I2C_BACKEND_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+
+/// \brief
+/// Interface for the bus that an i2c_ipass object talks to.
+/// \details
+/// A backend only knows about whole transactions: a write transaction sends n bytes to a device and a read transaction gets n bytes from it.
+/// Everything that has to do with registers is done by i2c_ipass on top of this.
+/// That way the same driver code can run on a real bus on the Arduino Due and on a simulated bus on a build machine.
+class i2c_backend {
+public:
+
+    virtual ~i2c_backend() = default;
+
+    /// \brief
+    /// Does one write transaction of n bytes to the given device.
+    virtual void write(const uint8_t & device_id, const uint8_t data[], const size_t & n) = 0;
+    
+    /// \brief
+    /// Does one read transaction of n bytes from the given device.
+    virtual void read(const uint8_t & device_id, uint8_t data[], const size_t & n) = 0;
+    
+    /// \brief
+    /// Writes n_out bytes to the given device and then reads n_in bytes from it.
+    /// \details
+    /// This is what a register read needs: first the register address is written and then the data is read.
+    /// By default it is just a write followed by a read, a backend that can do a repeated start overrides it so both go in one transaction.
+    virtual void write_read(const uint8_t & device_id, const uint8_t out[], const size_t & n_out, uint8_t in[], const size_t & n_in){
+        write(device_id, out, n_out);
+        read(device_id, in, n_in);
+    }
+};
+
+
+/// \brief
+/// i2c_backend that uses a hwlib i2c bus.
+/// \details
+/// Example: auto i2c_bus = hwlib::i2c_bus_bit_banged_scl_sda( scl,sda );
+/// Example: i2c_backend_hwlib backend(i2c_bus);
+///
+/// Every call is one hwlib::i2c_write_transaction or hwlib::i2c_read_transaction.
+/// The bus is kept by reference so it can still be used by other hwlib drivers.
+/// This works with any hwlib i2c bus, but hwlib's own bit banged bus runs at its default speed.
+/// See i2c_backend_bit_banged for a bit banged bus with a chosen clock and i2c_backend_twi for the hardware controller of the Arduino Due.
+class i2c_backend_hwlib : public i2c_backend {
+private:
+    hwlib::i2c_bus & bus;
+
+public:
+
+    i2c_backend_hwlib(hwlib::i2c_bus & bus):
+        bus(bus)
+    {}
+    
+    void write(const uint8_t & device_id, const uint8_t data[], const size_t & n) override {
+        hwlib::i2c_write_transaction(bus, device_id).write(data, n);
+    }
+    
+    void read(const uint8_t & device_id, uint8_t data[], const size_t & n) override {
+        hwlib::i2c_read_transaction(bus, device_id).read(data, n);
+    }
+};
+
+#endif
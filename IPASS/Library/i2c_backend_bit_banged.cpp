@@ -0,0 +1,154 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "i2c_backend_bit_banged.hpp"
+
+
+i2c_backend_bit_banged::i2c_backend_bit_banged(hwlib::pin_oc & scl, hwlib::pin_oc & sda, const uint32_t & clock_hz):
+        scl(scl),
+        sda(sda),
+        half_period_ns(500000000UL / clock_hz)
+    {
+        set_sda(1);
+        set_scl(1);
+    }
+
+
+void i2c_backend_bit_banged::wait_half_period(){
+    hwlib::wait_ns(half_period_ns);
+}
+
+
+void i2c_backend_bit_banged::set_scl(const bool & level){
+    scl.write(level);
+    scl.flush();
+    if(level){
+        // wait for a slave that stretches the clock, but don't hang on a shorted bus
+        for(int i = 0; i < 1000; i++){
+            scl.refresh();
+            if(scl.read()){
+                break;
+            }
+        }
+    }
+}
+
+
+void i2c_backend_bit_banged::set_sda(const bool & level){
+    sda.write(level);
+    sda.flush();
+}
+
+
+bool i2c_backend_bit_banged::get_sda(){
+    sda.refresh();
+    return sda.read();
+}
+
+
+void i2c_backend_bit_banged::write_start(){
+    set_sda(1);
+    set_scl(1);
+    wait_half_period();
+    set_sda(0);
+    wait_half_period();
+    set_scl(0);
+}
+
+
+void i2c_backend_bit_banged::write_stop(){
+    set_sda(0);
+    wait_half_period();
+    set_scl(1);
+    wait_half_period();
+    set_sda(1);
+    wait_half_period();
+}
+
+
+void i2c_backend_bit_banged::write_bit(const bool & bit){
+    set_sda(bit);
+    wait_half_period();
+    set_scl(1);
+    wait_half_period();
+    set_scl(0);
+}
+
+
+bool i2c_backend_bit_banged::read_bit(){
+    set_sda(1);
+    wait_half_period();
+    set_scl(1);
+    wait_half_period();
+    bool bit = get_sda();
+    set_scl(0);
+    return bit;
+}
+
+
+bool i2c_backend_bit_banged::write_byte(const uint8_t & byte){
+    for(int i = 7; i >= 0; i--){
+        write_bit((byte >> i) & 1);
+    }
+    return !read_bit();
+}
+
+
+uint8_t i2c_backend_bit_banged::read_byte(const bool & ack){
+    uint8_t byte = 0;
+    for(int i = 0; i < 8; i++){
+        byte = (byte << 1) | read_bit();
+    }
+    write_bit(!ack);
+    return byte;
+}
+
+
+void i2c_backend_bit_banged::write(const uint8_t & device_id, const uint8_t data[], const size_t & n){
+    write_start();
+    if(write_byte(device_id << 1)){
+        for(size_t i = 0; i < n; i++){
+            if(!write_byte(data[i])){
+                break;
+            }
+        }
+    }
+    write_stop();
+}
+
+
+void i2c_backend_bit_banged::read(const uint8_t & device_id, uint8_t data[], const size_t & n){
+    write_start();
+    write_byte((device_id << 1) | 1);
+    for(size_t i = 0; i < n; i++){
+        data[i] = read_byte(i + 1 < n);
+    }
+    write_stop();
+}
+
+
+void i2c_backend_bit_banged::write_read(const uint8_t & device_id, const uint8_t out[], const size_t & n_out, uint8_t in[], const size_t & n_in){
+    write_start();
+    bool answered = write_byte(device_id << 1);
+    for(size_t i = 0; answered && (i < n_out); i++){
+        answered = write_byte(out[i]);
+    }
+    if(answered){
+        write_start();
+        answered = write_byte((device_id << 1) | 1);
+    }
+    if(!answered){
+        // like write, the transaction stops at the first NACK, the bytes read are what a bus nobody pulls down gives
+        write_stop();
+        for(size_t i = 0; i < n_in; i++){
+            in[i] = 0xFF;
+        }
+        return;
+    }
+    for(size_t i = 0; i < n_in; i++){
+        in[i] = read_byte(i + 1 < n_in);
+    }
+    write_stop();
+}
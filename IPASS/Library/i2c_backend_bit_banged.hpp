@@ -0,0 +1,65 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef I2C_BACKEND_BIT_BANGED_HPP
+#define I2C_BACKEND_BIT_BANGED_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "i2c_backend.hpp"
+
+/// \brief
+/// Bit banged i2c_backend with a chosen clock speed.
+/// \details
+/// Example: i2c_backend_bit_banged backend(scl, sda, i2c_backend_bit_banged::fast_mode);
+///
+/// This does the same as hwlib's i2c_bus_bit_banged_scl_sda, but the time between the clock edges is worked out from the clock speed.
+/// The ADXL345 and the OLED both work in fast mode, which moves 4 times as many bits per second as the 100 kHz standard mode.
+/// The pins are only used as open collector outputs, so other drivers can still bit bang on the same pins between transactions.
+/// write_read uses a repeated start, so a register read is one transaction.
+/// When a device doesn't answer with an ACK the transaction is stopped, a write_read then returns 0xFF for every byte.
+///
+/// The real clock is a bit slower than asked because writing and reading the pins takes time too.
+/// A slave that holds SCL low (clock stretching) is waited for.
+class i2c_backend_bit_banged : public i2c_backend {
+private:
+    hwlib::pin_oc & scl;
+    hwlib::pin_oc & sda;
+    uint32_t half_period_ns;
+    
+    void wait_half_period();
+    void set_scl(const bool & level);
+    void set_sda(const bool & level);
+    bool get_sda();
+    void write_start();
+    void write_stop();
+    void write_bit(const bool & bit);
+    bool read_bit();
+    bool write_byte(const uint8_t & byte);
+    uint8_t read_byte(const bool & ack);
+
+public:
+
+    /// The clock of the i2c standard mode in Hz.
+    static constexpr uint32_t standard_mode = 100000;
+    
+    /// The clock of the i2c fast mode in Hz.
+    static constexpr uint32_t fast_mode = 400000;
+    
+    /// \brief
+    /// Constructor for a bit banged backend.
+    /// \details
+    /// The pins are kept by reference and the clock is in Hz, the default is fast mode.
+    i2c_backend_bit_banged(hwlib::pin_oc & scl, hwlib::pin_oc & sda, const uint32_t & clock_hz = fast_mode);
+    
+    void write(const uint8_t & device_id, const uint8_t data[], const size_t & n) override;
+    
+    void read(const uint8_t & device_id, uint8_t data[], const size_t & n) override;
+    
+    void write_read(const uint8_t & device_id, const uint8_t out[], const size_t & n_out, uint8_t in[], const size_t & n_in) override;
+};
+
+#endif
@@ -0,0 +1,103 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "i2c_backend_twi.hpp"
+
+#ifdef HWLIB_TARGET_arduino_due
+
+
+i2c_backend_twi::i2c_backend_twi(const uint32_t & clock_hz){
+    PMC->PMC_PCER0 = 1 << ID_TWI1;
+    
+    // give PB12 (TWD1) and PB13 (TWCK1) to peripheral A
+    PIOB->PIO_PDR = PIO_PB12A_TWD1 | PIO_PB13A_TWCK1;
+    PIOB->PIO_ABSR &= ~(PIO_PB12A_TWD1 | PIO_PB13A_TWCK1);
+    
+    TWI1->TWI_CR = TWI_CR_SWRST;
+    (void)TWI1->TWI_RHR;
+    TWI1->TWI_CR = TWI_CR_SVDIS | TWI_CR_MSDIS;
+    TWI1->TWI_CR = TWI_CR_MSEN;
+    
+    // the low and high time of the clock are each ((div * 2^ckdiv) + 4) master clock cycles
+    uint32_t div = (SystemCoreClock / (2 * clock_hz)) - 4;
+    uint32_t ckdiv = 0;
+    while((div > 255) && (ckdiv < 7)){
+        ckdiv++;
+        div /= 2;
+    }
+    TWI1->TWI_CWGR = TWI_CWGR_CLDIV(div) | TWI_CWGR_CHDIV(div) | TWI_CWGR_CKDIV(ckdiv);
+}
+
+
+bool i2c_backend_twi::wait_for(const uint32_t & status_bit){
+    for(uint32_t i = 0; i < 100000; i++){
+        uint32_t status = TWI1->TWI_SR;
+        if(status & TWI_SR_NACK){
+            return false;
+        }
+        if(status & status_bit){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void i2c_backend_twi::write(const uint8_t & device_id, const uint8_t data[], const size_t & n){
+    TWI1->TWI_MMR = TWI_MMR_DADR(device_id);
+    TWI1->TWI_IADR = 0;
+    for(size_t i = 0; i < n; i++){
+        TWI1->TWI_THR = data[i];
+        if(!wait_for(TWI_SR_TXRDY)){
+            break;
+        }
+    }
+    TWI1->TWI_CR = TWI_CR_STOP;
+    wait_for(TWI_SR_TXCOMP);
+}
+
+
+void i2c_backend_twi::read(const uint8_t & device_id, uint8_t data[], const size_t & n){
+    write_read(device_id, nullptr, 0, data, n);
+}
+
+
+void i2c_backend_twi::write_read(const uint8_t & device_id, const uint8_t out[], const size_t & n_out, uint8_t in[], const size_t & n_in){
+    if(n_in == 0){
+        // a read of 0 bytes would start the read and never stop it, so it is just the write
+        write(device_id, out, n_out);
+        return;
+    }
+    if(n_out > 3){
+        // the internal address holds at most 3 bytes
+        i2c_backend::write_read(device_id, out, n_out, in, n_in);
+        return;
+    }
+    uint32_t internal_address = 0;
+    for(size_t i = 0; i < n_out; i++){
+        internal_address = (internal_address << 8) | out[i];
+    }
+    TWI1->TWI_MMR = TWI_MMR_DADR(device_id) | TWI_MMR_MREAD | (n_out << TWI_MMR_IADRSZ_Pos);
+    TWI1->TWI_IADR = internal_address;
+    
+    bool answered = true;
+    if(n_in == 1){
+        TWI1->TWI_CR = TWI_CR_START | TWI_CR_STOP;
+    } else {
+        TWI1->TWI_CR = TWI_CR_START;
+    }
+    for(size_t i = 0; i < n_in; i++){
+        if((i + 1 == n_in) && (n_in > 1)){
+            TWI1->TWI_CR = TWI_CR_STOP;
+        }
+        if(answered){
+            answered = wait_for(TWI_SR_RXRDY);
+        }
+        in[i] = answered ? TWI1->TWI_RHR : 0xFF;
+    }
+    wait_for(TWI_SR_TXCOMP);
+}
+
+#endif
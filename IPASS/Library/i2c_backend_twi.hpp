@@ -0,0 +1,49 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef I2C_BACKEND_TWI_HPP
+#define I2C_BACKEND_TWI_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "i2c_backend.hpp"
+
+#ifdef HWLIB_TARGET_arduino_due
+
+/// \brief
+/// i2c_backend that uses the hardware TWI controller of the Arduino Due.
+/// \details
+/// Example: i2c_backend_twi backend(400000);
+///
+/// This uses TWI1, which is on pin 20 (SDA) and pin 21 (SCL) of the Due, the same pins the rest of the project uses.
+/// The controller shifts the bits out by itself, so the clock is exact and the processor only has to hand over the bytes.
+/// write_read uses the internal address mode of the controller, so a register read is one transaction with a repeated start.
+///
+/// Once this backend is made the pins belong to the controller, so nothing can bit bang on pin 20 and 21 anymore.
+/// Every device on the bus has to use this backend then.
+/// When a device doesn't answer the transaction is stopped and a read returns 0xFF, like a bit banged read would.
+class i2c_backend_twi : public i2c_backend {
+private:
+    bool wait_for(const uint32_t & status_bit);
+
+public:
+
+    /// \brief
+    /// Constructor for the TWI backend.
+    /// \details
+    /// The clock is in Hz, 400 kHz fast mode is the default and the highest the ADXL345 and the OLED can do.
+    i2c_backend_twi(const uint32_t & clock_hz = 400000);
+    
+    void write(const uint8_t & device_id, const uint8_t data[], const size_t & n) override;
+    
+    void read(const uint8_t & device_id, uint8_t data[], const size_t & n) override;
+    
+    void write_read(const uint8_t & device_id, const uint8_t out[], const size_t & n_out, uint8_t in[], const size_t & n_in) override;
+};
+
+#endif
+
+#endif
@@ -5,19 +5,42 @@
 //          https://www.boost.org/LICENSE_1_0.txt)
 
 #include "i2c_ipass.hpp"
+#include "profiling.hpp"
 
 
-i2c_ipass::i2c_ipass(const hwlib::i2c_bus_bit_banged_scl_sda & i2c_bus): i2c_bus(i2c_bus) {}
+i2c_ipass::i2c_ipass(i2c_backend & i2c_bus): i2c_bus(i2c_bus) {}
 
 
 void i2c_ipass::write(const uint8_t & register_address, const uint8_t & device_id, const uint8_t & data){
     const uint8_t writeBytes[2] = {register_address, data};
-    hwlib::i2c_write_transaction(i2c_bus, device_id).write(writeBytes, 2);
+    i2c_bus.write(device_id, writeBytes, 2);
+    IPASS_PROFILE_I2C(2);
+}
+
+
+void i2c_ipass::write(const uint8_t & register_address, const uint8_t & device_id, const uint8_t data[], const size_t & n){
+    uint8_t writeBytes[33];
+    for(size_t done = 0; done < n; done += 32){
+        size_t length = (n - done < 32) ? n - done : 32;
+        writeBytes[0] = register_address + done;
+        for(size_t i = 0; i < length; i++){
+            writeBytes[i + 1] = data[done + i];
+        }
+        i2c_bus.write(device_id, writeBytes, length + 1);
+        IPASS_PROFILE_I2C(length + 1);
+    }
 }
 
 
 uint8_t i2c_ipass::read(const uint8_t & register_address, const uint8_t & device_id){
-    hwlib::i2c_write_transaction(i2c_bus, device_id).write(register_address);
-    uint8_t data = hwlib::i2c_read_transaction(i2c_bus, device_id).read_byte();
+    uint8_t data;
+    i2c_bus.write_read(device_id, &register_address, 1, &data, 1);
+    IPASS_PROFILE_I2C(2);
     return data;
 }
+
+
+void i2c_ipass::read(const uint8_t & register_address, const uint8_t & device_id, uint8_t data[], const size_t & n){
+    i2c_bus.write_read(device_id, &register_address, 1, data, n);
+    IPASS_PROFILE_I2C(n + 1);
+}
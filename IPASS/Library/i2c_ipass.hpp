@@ -10,10 +10,12 @@
 /// @file
 
 #include "hwlib.hpp"
+#include "i2c_backend.hpp"
+#include "register_map.hpp"
 
 class i2c_ipass {
 private:
-    hwlib::i2c_bus_bit_banged_scl_sda i2c_bus;
+    i2c_backend & i2c_bus;
 
 public:
 
@@ -21,31 +23,75 @@ public:
     /// Constructor for an i2c_ipass object
     /// \details
     /// Example: i2c_ipass i2c_ipass_obect(i2c_bus);
-    /// This object requires an hwlib::i2c_bus_bit_banged_scl_sda object
-    i2c_ipass(const hwlib::i2c_bus_bit_banged_scl_sda & i2c_bus);
+    /// This object requires an i2c_backend object, like an i2c_backend_hwlib on the Arduino Due or an i2c_bus_simulated on a build machine.
+    /// The backend is kept by reference so it has to live at least as long as the i2c_ipass object.
+    i2c_ipass(i2c_backend & i2c_bus);
     
     /// \brief
     /// Writes an uint8_t variable to a register from the given module.
     /// \details
     /// Example: i2c_ipass_object.write(0x2D, 0x53, 8);
     ///
-    /// This function uses the hwlib::i2c_write_transaction and expects 3 uint8_t variables.
+    /// This function does one write transaction and expects 3 uint8_t variables.
     /// The device id of the module you want to write to.
     /// The register address that you want your data to be writen to on the module.
     /// And the byte you want to write to that register.
     void write(const uint8_t & register_address, const uint8_t & device_id, const uint8_t & data);
     
+    /// \brief
+    /// Writes n consecutive registers on the given module in one write transaction.
+    /// \details
+    /// Example: const uint8_t offsets[3] = {2, 254, 5};
+    /// Example: i2c_ipass_object.write(0x1E, 0x53, offsets, 3);
+    ///
+    /// The register address is only sent once, after that the module auto-increments its register pointer for every byte that is written.
+    /// It costs 1 transaction and n + 2 bytes on the bus, where calling write n times costs n transactions and 3 * n bytes.
+    /// More than 32 bytes are split up in transactions of 32.
+    void write(const uint8_t & register_address, const uint8_t & device_id, const uint8_t data[], const size_t & n);
+    
+    /// \brief
+    /// Writes a register given by its register_descriptor, a read only register doesn't compile.
+    /// \details
+    /// Example: i2c_ipass_object.write(POWER_CTL, 0x53, 8);
+    ///
+    /// This is picked over the uint8_t version whenever a descriptor is given, so writing DEVID or a data register is caught by the compiler.
+    template< uint8_t Address, register_access Access, uint8_t Width >
+    void write(const register_descriptor< Address, Access, Width > &, const uint8_t & device_id, const uint8_t & data){
+        static_assert(Access != register_access::read_only, "this register can only be read");
+        write(Address, device_id, data);
+    }
+    
+    /// \brief
+    /// Writes n consecutive registers starting at a register given by its register_descriptor, a read only start register doesn't compile.
+    template< uint8_t Address, register_access Access, uint8_t Width >
+    void write(const register_descriptor< Address, Access, Width > &, const uint8_t & device_id, const uint8_t data[], const size_t & n){
+        static_assert(Access != register_access::read_only, "this register can only be read");
+        write(Address, device_id, data, n);
+    }
+    
     /// \brief
     /// Reads and returns an uint8_t variable from the given module.
     /// \details
     /// Example: i2c_ipass_object.write(0x2D, 0x53);
     ///
-    /// This function uses the hwlib::i2c_read_transaction and the hwlib::i2c_write_transaction and expects 2 uint8_t variables.
+    /// This function writes the register address and then reads the data, as one transaction when the backend can do a repeated start, and expects 2 uint8_t variables.
     /// The device id of the module you want to read from.
     /// And the register address that you want to read from.
     /// It returns a uint8_t variable.
     uint8_t read(const uint8_t & register_address, const uint8_t & device_id);
     
+    /// \brief
+    /// Reads n consecutive registers from the given module in one read transaction.
+    /// \details
+    /// Example: uint8_t data[6];
+    /// Example: i2c_ipass_object.read(0x32, 0x53, data, 6);
+    ///
+    /// The register address is only written once, after that the module auto-increments its register pointer for every byte that is read.
+    /// This means that all n bytes come from the same moment in time, which matters for registers that belong together like the axis data.
+    /// It only costs 2 transactions (1 with a repeated start) no matter how many bytes are read, where calling read n times costs 2 * n transactions.
+    /// The data array must be at least n long.
+    void read(const uint8_t & register_address, const uint8_t & device_id, uint8_t data[], const size_t & n);
+    
 };
 
 #endif
@@ -0,0 +1,91 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "latency_histogram.hpp"
+
+
+latency_histogram::latency_histogram(){
+    reset();
+}
+
+
+void latency_histogram::record(const uint32_t & latency_us){
+    size_t index = latency_us / bucket_us;
+    if(index >= bucket_count){
+        index = bucket_count - 1;
+    }
+    buckets[index]++;
+    if((recorded == 0) || (latency_us < min)){
+        min = latency_us;
+    }
+    if(latency_us > max){
+        max = latency_us;
+    }
+    total += latency_us;
+    recorded++;
+}
+
+
+void latency_histogram::reset(){
+    buckets.fill(0);
+    recorded = 0;
+    min = 0;
+    max = 0;
+    total = 0;
+}
+
+
+uint32_t latency_histogram::count() const {
+    return recorded;
+}
+
+
+uint32_t latency_histogram::min_us() const {
+    return min;
+}
+
+
+uint32_t latency_histogram::max_us() const {
+    return max;
+}
+
+
+uint32_t latency_histogram::mean_us() const {
+    if(recorded == 0){
+        return 0;
+    }
+    return total / recorded;
+}
+
+
+uint32_t latency_histogram::percentile_us(const uint8_t & percent) const {
+    uint64_t needed = (static_cast<uint64_t>(recorded) * percent + 99) / 100;
+    uint64_t counted = 0;
+    for(size_t i = 0; i < bucket_count - 1; i++){
+        counted += buckets[i];
+        if((counted >= needed) && (counted > 0)){
+            uint32_t edge = (i + 1) * bucket_us;
+            return edge < max ? edge : max;
+        }
+    }
+    return max;
+}
+
+
+uint32_t latency_histogram::bucket(const size_t & i) const {
+    return buckets[i];
+}
+
+
+hwlib::ostream & operator<<(hwlib::ostream & lhs, const latency_histogram & rhs){
+    lhs << rhs.count() << "x min " << rhs.min_us() << "us mean " << rhs.mean_us() 
+        << "us p99 " << rhs.percentile_us(99) << "us max " << rhs.max_us() << "us";
+    for(size_t i = 0; i < latency_histogram::bucket_count; i++){
+        if(rhs.bucket(i) != 0){
+            lhs << "\n  " << i << " ms: " << rhs.bucket(i);
+        }
+    }
+    return lhs;
+}
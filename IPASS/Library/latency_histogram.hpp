@@ -0,0 +1,125 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+/// @file
+
+#include <array>
+#include "hwlib.hpp"
+
+/// \brief
+/// Histogram of latencies in us, with the min, mean, max and percentiles of what was recorded.
+/// \details
+/// Example: latency_histogram input_latency;
+/// Example: input_latency.record(hwlib::now_us() - sample_time_us);
+/// Example: hwlib::cout << input_latency << hwlib::endl;
+///
+/// The buckets are 1 ms wide, everything of 127 ms or more goes in the last bucket.
+/// The min, max and mean are kept exactly, a percentile is the upper edge of the bucket it falls in, but never more than the max.
+/// Everything has a fixed size and nothing is allocated, so it can be recorded in the game loop on the Due as well as in the host simulator.
+class latency_histogram {
+public:
+
+    /// The width of one bucket in us.
+    static constexpr uint32_t bucket_us = 1000;
+    
+    /// The amount of buckets, the last one also holds everything that is longer.
+    static constexpr size_t bucket_count = 128;
+
+private:
+    std::array< uint32_t, bucket_count > buckets;
+    uint32_t recorded;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+
+public:
+
+    /// \brief
+    /// Constructor for an empty latency_histogram.
+    latency_histogram();
+    
+    /// \brief
+    /// Adds one latency in us.
+    void record(const uint32_t & latency_us);
+    
+    /// \brief
+    /// Forgets everything that was recorded.
+    void reset();
+    
+    /// \brief
+    /// Returns the amount of recorded latencies.
+    uint32_t count() const;
+    
+    /// \brief
+    /// Returns the shortest recorded latency in us, or 0 when nothing was recorded.
+    uint32_t min_us() const;
+    
+    /// \brief
+    /// Returns the longest recorded latency in us.
+    uint32_t max_us() const;
+    
+    /// \brief
+    /// Returns the average of the recorded latencies in us, rounded down.
+    uint32_t mean_us() const;
+    
+    /// \brief
+    /// Returns the latency in us that percent of the recorded latencies are at or below.
+    /// \details
+    /// Example: uint32_t p99 = input_latency.percentile_us(99);
+    uint32_t percentile_us(const uint8_t & percent) const;
+    
+    /// \brief
+    /// Returns how many latencies are in bucket i, bucket i holds i ms up to i + 1 ms.
+    uint32_t bucket(const size_t & i) const;
+};
+
+/// \brief
+/// Keeps the time stamps of samples that are in use but not yet on the screen, until a flush shows them.
+/// \details
+/// Example: tracer.stamp(sample.time_us);
+/// Example: tracer.shown(paddle.input_time_us(), hwlib::now_us(), input_latency);
+///
+/// Every sample that goes into a filter gets stamped, and after a flush every stamp up to the newest sample behind what was drawn is recorded and forgotten.
+/// That way a sample that waited in the FIFO or in a frame without an update counts with its whole wait, not only the newest sample of a batch.
+/// When more than N samples are waiting the newest ones are not stamped.
+template< size_t N >
+class latency_tracer {
+private:
+    std::array< uint_fast64_t, N > pending;
+    size_t amount = 0;
+
+public:
+
+    /// \brief
+    /// Remembers the time a sample was taken.
+    void stamp(const uint_fast64_t & sample_time_us){
+        if(amount < N){
+            pending[amount++] = sample_time_us;
+        }
+    }
+    
+    /// \brief
+    /// Records now_us minus the stamp of every sample up to shown_up_to_us in latencies and forgets them.
+    void shown(const uint_fast64_t & shown_up_to_us, const uint_fast64_t & now_us, latency_histogram & latencies){
+        size_t kept = 0;
+        for(size_t i = 0; i < amount; i++){
+            if(pending[i] <= shown_up_to_us){
+                latencies.record(now_us - pending[i]);
+            } else {
+                pending[kept++] = pending[i];
+            }
+        }
+        amount = kept;
+    }
+};
+
+/// \brief
+/// Prints the count, min, mean, p99 and max on one line and then every bucket that isn't empty.
+hwlib::ostream & operator<<(hwlib::ostream & lhs, const latency_histogram & rhs);
+
+#endif
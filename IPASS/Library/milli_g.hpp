@@ -0,0 +1,89 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MILLI_G_HPP
+#define MILLI_G_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+
+/// \brief
+/// Fixed point acceleration in milli-g.
+/// \details
+/// The value is stored as an int32_t with 8 fraction bits, so the smallest step is 1/256 mg.
+/// That is enough to hold every ADXL345 scale factor without rounding, 3.9 mg for example is exactly 1000/256 mg.
+/// Hwlib cannot print floats so the whole milli-g are printed instead.
+class milli_g {
+private:
+    int32_t value;
+
+public:
+
+    /// The amount of fraction bits in the stored value.
+    static constexpr int fraction_bits = 8;
+    
+    /// \brief
+    /// Constructor for a milli_g from whole milli-g.
+    /// \details
+    /// Example: milli_g threshold(300);
+    constexpr explicit milli_g(const int32_t & whole = 0):
+        value(whole * (1 << fraction_bits))
+    {}
+    
+    /// \brief
+    /// Creates a milli_g from a value that already has fraction_bits fraction bits.
+    static constexpr milli_g from_fixed(const int32_t & fixed){
+        milli_g result;
+        result.value = fixed;
+        return result;
+    }
+    
+    /// \brief
+    /// Returns the stored value including the fraction bits.
+    constexpr int32_t fixed() const {
+        return value;
+    }
+    
+    /// \brief
+    /// Returns the value rounded to whole milli-g.
+    constexpr int32_t whole() const {
+        return (value + (1 << (fraction_bits - 1))) >> fraction_bits;
+    }
+    
+    constexpr milli_g operator+(const milli_g & rhs) const {
+        return from_fixed(value + rhs.value);
+    }
+    
+    constexpr milli_g operator-(const milli_g & rhs) const {
+        return from_fixed(value - rhs.value);
+    }
+    
+    constexpr milli_g operator-() const {
+        return from_fixed(-value);
+    }
+    
+    constexpr bool operator==(const milli_g & rhs) const {
+        return value == rhs.value;
+    }
+    
+    constexpr bool operator!=(const milli_g & rhs) const {
+        return value != rhs.value;
+    }
+    
+    constexpr bool operator<(const milli_g & rhs) const {
+        return value < rhs.value;
+    }
+    
+    constexpr bool operator>(const milli_g & rhs) const {
+        return value > rhs.value;
+    }
+};
+
+inline hwlib::ostream & operator<<(hwlib::ostream & lhs, const milli_g & rhs){
+    return lhs << rhs.whole();
+}
+
+#endif
@@ -0,0 +1,54 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "profiling.hpp"
+
+
+static profiling::stats counters;
+
+
+const profiling::stats & profiling::statistics(){
+    return counters;
+}
+
+
+void profiling::reset(){
+    counters = stats();
+}
+
+
+void profiling::record(const section & s, const uint32_t & duration_us){
+    auto & counted = counters.sections[static_cast<size_t>(s)];
+    counted.calls++;
+    counted.total_us += duration_us;
+    if(duration_us > counted.max_us){
+        counted.max_us = duration_us;
+    }
+}
+
+
+void profiling::count_i2c(const size_t & bytes){
+    counters.i2c_transactions++;
+    counters.i2c_bytes += bytes;
+}
+
+
+const char * profiling::name(const section & s){
+    static const char * names[] = {"sensors", "collision", "score", "draw", "flush", "frame"};
+    return names[static_cast<size_t>(s)];
+}
+
+
+hwlib::ostream & operator<<(hwlib::ostream & lhs, const profiling::stats & rhs){
+    for(size_t i = 0; i < rhs.sections.size(); i++){
+        const auto & counted = rhs.sections[i];
+        if(counted.calls == 0){
+            continue;
+        }
+        lhs << profiling::name(static_cast<profiling::section>(i))
+            << " " << counted.calls << "x avg " << (counted.total_us / counted.calls) << "us max " << counted.max_us << "us\n";
+    }
+    return lhs << "i2c " << rhs.i2c_transactions << " transactions " << rhs.i2c_bytes << " bytes";
+}
@@ -0,0 +1,119 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef PROFILING_HPP
+#define PROFILING_HPP
+
+/// @file
+
+#include <array>
+#include "hwlib.hpp"
+
+/// \brief
+/// Counters that show where the time of a frame goes.
+/// \details
+/// Example: { IPASS_PROFILE_SCOPE(profiling::section::flush); oled.flush(); }
+/// Example: hwlib::cout << profiling::statistics() << hwlib::endl;
+///
+/// Every section keeps how often it ran, its total time and its longest time in us, measured with hwlib::now_us().
+/// i2c_ipass counts its transactions and bytes here as well.
+/// Everything is kept in one fixed size stats struct, so it can be printed over hwlib::cout on the Due or read directly by the host simulator.
+///
+/// Define IPASS_NO_PROFILING when compiling to compile all IPASS_PROFILE_ macros out, then they cost nothing at all.
+namespace profiling {
+
+/// \brief
+/// The parts of a frame that are timed.
+enum class section : uint8_t {
+    sensors,
+    collision,
+    score,
+    draw,
+    flush,
+    frame,
+    amount
+};
+
+/// \brief
+/// How often a section ran, how long it took in total and how long it took at most, in us.
+struct section_stats {
+    uint32_t calls = 0;
+    uint32_t total_us = 0;
+    uint32_t max_us = 0;
+};
+
+/// \brief
+/// Everything that has been counted since the last reset.
+/// \details
+/// i2c_transactions is the amount of calls to an i2c_backend by i2c_ipass and the OLED, a write_read is one call even when the backend needs 2 transactions for it.
+/// i2c_bytes is the amount of bytes handed to the backend in those calls: register addresses, commands and data, but not the address byte of the device.
+/// i2c_bus_simulated::get_calls and get_handed_bytes count the same way, the bus time and the bytes on the wire come from its other counters.
+struct stats {
+    std::array< section_stats, static_cast<size_t>(section::amount) > sections;
+    uint32_t i2c_transactions = 0;
+    uint32_t i2c_bytes = 0;
+};
+
+/// \brief
+/// Returns the counters.
+const stats & statistics();
+
+/// \brief
+/// Sets all counters back to 0.
+void reset();
+
+/// \brief
+/// Adds one run of a section that took duration_us.
+void record(const section & s, const uint32_t & duration_us);
+
+/// \brief
+/// Adds one i2c transaction that moved the given amount of bytes.
+void count_i2c(const size_t & bytes);
+
+/// \brief
+/// Returns the name of a section for printing.
+const char * name(const section & s);
+
+/// \brief
+/// Times the scope it lives in and records it as a section when it goes out of scope.
+/// \details
+/// Use IPASS_PROFILE_SCOPE instead of this class directly, so it can be compiled out.
+class scoped_timer {
+private:
+    section timed;
+    uint_fast64_t start;
+
+public:
+    scoped_timer(const section & timed):
+        timed(timed),
+        start(hwlib::now_us())
+    {}
+    
+    ~scoped_timer(){
+        record(timed, hwlib::now_us() - start);
+    }
+};
+
+}
+
+hwlib::ostream & operator<<(hwlib::ostream & lhs, const profiling::stats & rhs);
+
+#define IPASS_PROFILE_CONCAT_INNER(a, b) a ## b
+#define IPASS_PROFILE_CONCAT(a, b) IPASS_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef IPASS_NO_PROFILING
+    #define IPASS_PROFILE_SCOPE(s)
+    #define IPASS_PROFILE_I2C(bytes)
+#else
+    /// \brief
+    /// Times the rest of the current scope as section s.
+    #define IPASS_PROFILE_SCOPE(s) profiling::scoped_timer IPASS_PROFILE_CONCAT(profile_timer_, __LINE__)(s)
+    
+    /// \brief
+    /// Counts one i2c transaction of the given amount of bytes.
+    #define IPASS_PROFILE_I2C(bytes) profiling::count_i2c(bytes)
+#endif
+
+#endif
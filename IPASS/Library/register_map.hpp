@@ -0,0 +1,82 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef REGISTER_MAP_HPP
+#define REGISTER_MAP_HPP
+
+/// @file
+
+#include <stdint.h>
+
+/// \brief
+/// What can be done with a register.
+enum class register_access : uint8_t {
+    read_only,
+    read_write
+};
+
+/// \brief
+/// Compile time description of one register of an i2c device.
+/// \details
+/// Example: constexpr register_descriptor< 0x2D > POWER_CTL{};
+///
+/// Address is the register address, Access tells if it can be written and Width is its size in bytes.
+/// A descriptor converts to its uint8_t address, so it can be given to every function that takes a register address.
+/// The typed functions like i2c_ipass::write, ADXL345::write_register and ADXL345::write_bits use Access to refuse a read only register at compile time.
+/// ADXL345 only writes registers through those, so a descriptor can't reach a write on a plain address there.
+template< uint8_t Address, register_access Access = register_access::read_write, uint8_t Width = 1 >
+struct register_descriptor {
+    static constexpr uint8_t address = Address;
+    static constexpr register_access access = Access;
+    static constexpr uint8_t width = Width;
+    static constexpr bool writable = (Access != register_access::read_only);
+    
+    constexpr operator uint8_t() const {
+        return Address;
+    }
+};
+
+/// \brief
+/// Values for some of the bits of register R.
+/// \details
+/// Example: constexpr auto bits = fifo_ctl::mode(2) | fifo_ctl::samples(8); // mask 0xDF, value 0x88
+///
+/// They are made by a register_field and combined with |, bits of different registers can't be combined because their types differ.
+/// mask has the bits that are set by one of the fields, value has their new values.
+template< typename R >
+struct register_bits {
+    uint8_t mask;
+    uint8_t value;
+    
+    constexpr register_bits operator|(const register_bits & rhs) const {
+        return { static_cast<uint8_t>(mask | rhs.mask), static_cast<uint8_t>(value | rhs.value) };
+    }
+};
+
+/// \brief
+/// A named group of Bits bits at Shift in register R.
+/// \details
+/// Example: constexpr register_field< decltype(POWER_CTL), 3, 1 > measure{};
+/// Example: uint8_t entries = fifo_status::entries.get(byte);
+///
+/// Calling a field with a value gives the register_bits for it, the value is cut off at the width of the field.
+/// get does the opposite and takes the field out of a byte that was read from the register.
+/// The mask and the shift are constants, so none of this costs anything at runtime.
+template< typename R, uint8_t Shift, uint8_t Bits >
+struct register_field {
+    using register_type = R;
+    static constexpr uint8_t shift = Shift;
+    static constexpr uint8_t mask = ((1U << Bits) - 1) << Shift;
+    
+    constexpr register_bits< R > operator()(const uint8_t & value) const {
+        return { mask, static_cast<uint8_t>((value << Shift) & mask) };
+    }
+    
+    constexpr uint8_t get(const uint8_t & byte) const {
+        return (byte & mask) >> Shift;
+    }
+};
+
+#endif
@@ -9,69 +9,202 @@
 
 /// @file
 
+#include "register_map.hpp"
+
 /// \brief 
-/// this file contains defines for all the registers for the ADXL345 Accelerometer
+/// this file contains the descriptors for all the registers for the ADXL345 Accelerometer
 /// \description
+/// Every register is a register_descriptor, it converts to its address so it can be used as a uint8_t.
+/// The registers that the sensor changes by itself are read only.
+///
+/// DEVID: Device ID
+/// THRESH_TAP: Tap threshold
+/// OFSX: X-axis offset
+/// OFSY: Y-axis offset
+/// OFSZ: Z-axis offset
+/// DUR: Tap duration
+/// LATENT: Tap latency
+/// WINDOW: Tap window
+/// THRESH_ACT: Activity threshold
+/// THRESH_INACT: Inactivity threshold
+/// TIME_INACT: Inactivity time
+/// ACT_INACT_CTL: Axis enable control for activity and inactivity detection
+/// THRESH_FF: Free-fall threshold
+/// TIME_FF: Free-fall time
+/// TAP_AXES: Axis Control for single tap/double tap
+/// ACT_TAP_STATUS: Source of single tap/double tap
+/// BW_RATE: Data rate and power mode control
+/// POWER_CTL: Power saving features control
+/// INT_ENABLE: Interrupt enable control
+/// INT_MAP: Interupt mapping control
+/// INT_SOURCE: Source of interupts
+/// DATA_FORMAT: Data format control
+/// DATAX0: X-Axis Data 0
+/// DATAX1: X-Axis Data 1
+/// DATAY0: Y-Axis Data 0
+/// DATAY1: Y-Axis Data 1
+/// DATAZ0: Z-Axis Data 0
+/// DATAZ1: Z-Axis Data 1
+/// FIFO_CTL: FIFO control
+/// FIFO_STATUS: FIFO status
+
 /// DEVID: Device ID
+constexpr register_descriptor< 0x00, register_access::read_only > DEVID{};
+
 /// THRESH_TAP: Tap threshold
+constexpr register_descriptor< 0x1D > THRESH_TAP{};
+
 /// OFSX: X-axis offset
+constexpr register_descriptor< 0x1E > OFSX{};
+
 /// OFSY: Y-axis offset
+constexpr register_descriptor< 0x1F > OFSY{};
+
 /// OFSZ: Z-axis offset
+constexpr register_descriptor< 0x20 > OFSZ{};
+
 /// DUR: Tap duration
+constexpr register_descriptor< 0x21 > DUR{};
+
 /// LATENT: Tap latency
+constexpr register_descriptor< 0x22 > LATENT{};
+
 /// WINDOW: Tap window
+constexpr register_descriptor< 0x23 > WINDOW{};
+
 /// THRESH_ACT: Activity threshold
+constexpr register_descriptor< 0x24 > THRESH_ACT{};
+
 /// THRESH_INACT: Inactivity threshold
+constexpr register_descriptor< 0x25 > THRESH_INACT{};
+
 /// TIME_INACT: Inactivity time
+constexpr register_descriptor< 0x26 > TIME_INACT{};
+
 /// ACT_INACT_CTL: Axis enable control for activity and inactivity detection
+constexpr register_descriptor< 0x27 > ACT_INACT_CTL{};
+
 /// THRESH_FF: Free-fall threshold
+constexpr register_descriptor< 0x28 > THRESH_FF{};
+
 /// TIME_FF: Free-fall time
+constexpr register_descriptor< 0x29 > TIME_FF{};
+
 /// TAP_AXES: Axis Control for single tap/double tap
+constexpr register_descriptor< 0x2A > TAP_AXES{};
+
 /// ACT_TAP_STATUS: Source of single tap/double tap
+constexpr register_descriptor< 0x2B, register_access::read_only > ACT_TAP_STATUS{};
+
 /// BW_RATE: Data rate and power mode control
+constexpr register_descriptor< 0x2C > BW_RATE{};
+
 /// POWER_CTL: Power saving features control
+constexpr register_descriptor< 0x2D > POWER_CTL{};
+
 /// INT_ENABLE: Interrupt enable control
+constexpr register_descriptor< 0x2E > INT_ENABLE{};
+
 /// INT_MAP: Interupt mapping control
+constexpr register_descriptor< 0x2F > INT_MAP{};
+
 /// INT_SOURCE: Source of interupts
+constexpr register_descriptor< 0x30, register_access::read_only > INT_SOURCE{};
+
 /// DATA_FORMAT: Data format control
+constexpr register_descriptor< 0x31 > DATA_FORMAT{};
+
 /// DATAX0: X-Axis Data 0
+constexpr register_descriptor< 0x32, register_access::read_only > DATAX0{};
+
 /// DATAX1: X-Axis Data 1
+constexpr register_descriptor< 0x33, register_access::read_only > DATAX1{};
+
 /// DATAY0: Y-Axis Data 0
+constexpr register_descriptor< 0x34, register_access::read_only > DATAY0{};
+
 /// DATAY1: Y-Axis Data 1
+constexpr register_descriptor< 0x35, register_access::read_only > DATAY1{};
+
 /// DATAZ0: Z-Axis Data 0
+constexpr register_descriptor< 0x36, register_access::read_only > DATAZ0{};
+
 /// DATAZ1: Z-Axis Data 1
+constexpr register_descriptor< 0x37, register_access::read_only > DATAZ1{};
+
 /// FIFO_CTL: FIFO control
+constexpr register_descriptor< 0x38 > FIFO_CTL{};
+
 /// FIFO_STATUS: FIFO status
+constexpr register_descriptor< 0x39, register_access::read_only > FIFO_STATUS{};
+
+/// \brief
+/// The fields of ACT_INACT_CTL: ac coupling and the enabled axis for activity (high half) and inactivity (low half).
+namespace act_inact_ctl {
+    constexpr register_field< decltype(ACT_INACT_CTL), 7, 1 > act_ac{};
+    constexpr register_field< decltype(ACT_INACT_CTL), 4, 3 > act_axes{};
+    constexpr register_field< decltype(ACT_INACT_CTL), 3, 1 > inact_ac{};
+    constexpr register_field< decltype(ACT_INACT_CTL), 0, 3 > inact_axes{};
+}
+
+/// \brief
+/// The fields of TAP_AXES: double tap suppression and the axis that take part in tap detection.
+namespace tap_axes {
+    constexpr register_field< decltype(TAP_AXES), 3, 1 > suppress{};
+    constexpr register_field< decltype(TAP_AXES), 0, 3 > axes{};
+}
+
+/// \brief
+/// The fields of ACT_TAP_STATUS: the axis of the last activity, the asleep bit and the axis of the last tap.
+namespace act_tap_status {
+    constexpr register_field< decltype(ACT_TAP_STATUS), 4, 3 > act_axes{};
+    constexpr register_field< decltype(ACT_TAP_STATUS), 3, 1 > asleep{};
+    constexpr register_field< decltype(ACT_TAP_STATUS), 0, 3 > tap_axes{};
+}
+
+/// \brief
+/// The fields of BW_RATE: low power mode and the rate code.
+namespace bw_rate {
+    constexpr register_field< decltype(BW_RATE), 4, 1 > low_power{};
+    constexpr register_field< decltype(BW_RATE), 0, 4 > rate{};
+}
+
+/// \brief
+/// The fields of POWER_CTL.
+namespace power_ctl {
+    constexpr register_field< decltype(POWER_CTL), 5, 1 > link{};
+    constexpr register_field< decltype(POWER_CTL), 4, 1 > auto_sleep{};
+    constexpr register_field< decltype(POWER_CTL), 3, 1 > measure{};
+    constexpr register_field< decltype(POWER_CTL), 2, 1 > sleep{};
+    constexpr register_field< decltype(POWER_CTL), 0, 2 > wakeup{};
+}
+
+/// \brief
+/// The fields of DATA_FORMAT.
+/// \details
+/// Inside the ADXL345 class data_format is the format template, use ::data_format there.
+namespace data_format {
+    constexpr register_field< decltype(DATA_FORMAT), 7, 1 > self_test{};
+    constexpr register_field< decltype(DATA_FORMAT), 6, 1 > spi{};
+    constexpr register_field< decltype(DATA_FORMAT), 5, 1 > int_invert{};
+    constexpr register_field< decltype(DATA_FORMAT), 3, 1 > full_res{};
+    constexpr register_field< decltype(DATA_FORMAT), 2, 1 > justify{};
+    constexpr register_field< decltype(DATA_FORMAT), 0, 2 > range{};
+}
+
+/// \brief
+/// The fields of FIFO_CTL: the FIFO mode, the pin that triggers trigger mode and the watermark.
+namespace fifo_ctl {
+    constexpr register_field< decltype(FIFO_CTL), 6, 2 > mode{};
+    constexpr register_field< decltype(FIFO_CTL), 5, 1 > trigger{};
+    constexpr register_field< decltype(FIFO_CTL), 0, 5 > samples{};
+}
 
-#define DEVID           0x00 /// DEVID: Device ID
-#define THRESH_TAP      0x1D /// THRESH_TAP: Tap threshold
-#define OFSX            0x1E /// OFSX: X-axis offset
-#define OFSY            0x1F /// OFSY: Y-axis offset
-#define OFSZ            0x20 /// OFSZ: Z-axis offset
-#define DUR             0x21 /// DUR: Tap duration
-#define LATENT          0x22 /// LATENT: Tap latency
-#define WINDOW          0x23 /// WINDOW: Tap window
-#define THRESH_ACT      0x24 /// THRESH_ACT: Activity threshold
-#define THRESH_INACT    0x25 /// THRESH_INACT: Inactivity threshold
-#define TIME_INACT      0x26 /// TIME_INACT: Inactivity time
-#define ACT_INACT_CTL   0x27 /// ACT_INACT_CTL: Axis enable control for activity and inactivity detection
-#define THRESH_FF       0x28 /// THRESH_FF: Free-fall threshold
-#define TIME_FF         0x29 /// TIME_FF: Free-fall time
-#define TAP_AXES        0x2A /// TAP_AXES: Axis Control for single tap/double tap
-#define ACT_TAP_STATUS  0x2B /// ACT_TAP_STATUS: Source of single tap/double tap
-#define BW_RATE         0x2C /// BW_RATE: Data rate and power mode control
-#define POWER_CTL       0x2D /// POWER_CTL: Power saving features control
-#define INT_ENABLE      0x2E /// INT_ENABLE: Interrupt enable control
-#define INT_MAP         0x2F /// INT_MAP: Interupt mapping control
-#define INT_SOURCE      0x30 /// INT_SOURCE: Source of interupts
-#define DATA_FORMAT     0x31 /// DATA_FORMAT: Data format control
-#define DATAX0          0x32 /// DATAX0: X-Axis Data 0
-#define DATAX1          0x33 /// DATAX1: X-Axis Data 1
-#define DATAY0          0x34 /// DATAY0: Y-Axis Data 0
-#define DATAY1          0x35 /// DATAY1: Y-Axis Data 1
-#define DATAZ0          0x36 /// DATAZ0: Z-Axis Data 0
-#define DATAZ1          0x37 /// DATAZ1: Z-Axis Data 1
-#define FIFO_CTL        0x38 /// FIFO_CTL: FIFO control
-#define FIFO_STATUS     0x39 /// FIFO_STATUS: FIFO status
+/// \brief
+/// The fields of FIFO_STATUS: if a trigger event happened and the amount of samples in the FIFO.
+namespace fifo_status {
+    constexpr register_field< decltype(FIFO_STATUS), 7, 1 > fifo_trig{};
+    constexpr register_field< decltype(FIFO_STATUS), 0, 6 > entries{};
+}
 
 #endif
@@ -0,0 +1,103 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+/// @file
+
+#include <array>
+#include <atomic>
+#include "ADXL345.hpp"
+
+/// \brief
+/// Single producer, single consumer ring buffer without locks.
+/// \details
+/// Example: ring_buffer< timed_sample, 64 > samples;
+/// Example: samples.push( s );
+/// Example: samples.pop_all( [&]( const timed_sample & s ){ filter.add( s.value ); } );
+///
+/// One side (an interrupt handler or the FIFO drain) only pushes, the other side (the game logic) only pops.
+/// The producer is the only one that writes head and the consumer the only one that writes tail, so no side ever has to wait for the other.
+/// Items are written before head is published with release order, and the consumer reads head with acquire order, so a popped item is always complete.
+///
+/// N has to be a power of 2, one place is kept free to tell a full buffer from an empty one so it holds N - 1 items.
+/// When the buffer is full push drops the new item, the consumer decides how much history it keeps.
+template< typename T, size_t N >
+class ring_buffer {
+private:
+
+    static_assert( N >= 2 && ( N & ( N - 1 ) ) == 0, "N has to be a power of 2" );
+
+    std::array< T, N > items;
+    std::atomic< size_t > head{ 0 };
+    std::atomic< size_t > tail{ 0 };
+    
+public:
+
+    /// \brief
+    /// Adds an item, returns false when the buffer is full. Only call this from the producer.
+    bool push( const T & item ){
+        size_t h = head.load( std::memory_order_relaxed );
+        size_t next = ( h + 1 ) & ( N - 1 );
+        if( next == tail.load( std::memory_order_acquire ) ){
+            return false;
+        }
+        items[ h ] = item;
+        head.store( next, std::memory_order_release );
+        return true;
+    }
+    
+    /// \brief
+    /// Takes the oldest item, returns false when the buffer is empty. Only call this from the consumer.
+    bool pop( T & item ){
+        size_t t = tail.load( std::memory_order_relaxed );
+        if( t == head.load( std::memory_order_acquire ) ){
+            return false;
+        }
+        item = items[ t ];
+        tail.store( ( t + 1 ) & ( N - 1 ), std::memory_order_release );
+        return true;
+    }
+    
+    /// \brief
+    /// Hands every waiting item, oldest first, to consumer and returns how many there were. Only call this from the consumer.
+    /// \details
+    /// Items the producer pushes while this runs are left for the next call.
+    template< typename F >
+    size_t pop_all( F consumer ){
+        size_t t = tail.load( std::memory_order_relaxed );
+        size_t h = head.load( std::memory_order_acquire );
+        size_t amount = ( h - t ) & ( N - 1 );
+        for( ; t != h; t = ( t + 1 ) & ( N - 1 ) ){
+            consumer( items[ t ] );
+        }
+        tail.store( h, std::memory_order_release );
+        return amount;
+    }
+    
+    /// \brief
+    /// Returns the amount of waiting items, from either side it is a snapshot.
+    size_t size() const {
+        return ( head.load( std::memory_order_acquire ) - tail.load( std::memory_order_acquire ) ) & ( N - 1 );
+    }
+    
+    bool empty() const {
+        return size() == 0;
+    }
+    
+    static constexpr size_t capacity(){
+        return N - 1;
+    }
+};
+
+/// \brief
+/// A sample of one sensor with the hwlib::now_us() time it was taken at.
+struct timed_sample {
+    uint_fast64_t time_us = 0;
+    ADXL345::sample value = {};
+};
+
+#endif
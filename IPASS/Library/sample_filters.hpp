@@ -0,0 +1,152 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SAMPLE_FILTERS_HPP
+#define SAMPLE_FILTERS_HPP
+
+/// @file
+
+#include <array>
+#include "ADXL345.hpp"
+
+/// \brief
+/// Average of the last N samples.
+/// \details
+/// Example: moving_average< 8 > average;
+/// Example: average.add( sample ); auto smooth = average.value();
+///
+/// The sums are kept up to date on every add, so value() is a division per axis no matter how big N is.
+/// Until N samples have been added the average is over the samples there are.
+template< size_t N >
+class moving_average {
+private:
+    std::array< ADXL345::sample, N > history = {};
+    size_t next = 0;
+    size_t count = 0;
+    int32_t sum_x = 0, sum_y = 0, sum_z = 0;
+
+public:
+
+    void add( const ADXL345::sample & s ){
+        if( count == N ){
+            sum_x -= history[ next ].x;
+            sum_y -= history[ next ].y;
+            sum_z -= history[ next ].z;
+        } else {
+            count++;
+        }
+        history[ next ] = s;
+        sum_x += s.x;
+        sum_y += s.y;
+        sum_z += s.z;
+        next = ( next + 1 ) % N;
+    }
+    
+    ADXL345::sample value() const {
+        if( count == 0 ){
+            return ADXL345::sample{ 0, 0, 0 };
+        }
+        return ADXL345::sample{ 
+            static_cast< int16_t >( sum_x / static_cast< int32_t >( count ) ), 
+            static_cast< int16_t >( sum_y / static_cast< int32_t >( count ) ), 
+            static_cast< int16_t >( sum_z / static_cast< int32_t >( count ) ) 
+        };
+    }
+};
+
+/// \brief
+/// Exponential average that moves 1 / 2^shift of the way to every new sample.
+/// \details
+/// Example: exponential_filter< 2 > smooth;
+///
+/// It needs no history, only the filtered value with 8 fraction bits so small steps don't get lost.
+/// The first sample sets the value directly so the filter doesn't have to climb up from 0.
+template< int shift >
+class exponential_filter {
+private:
+    int32_t x = 0, y = 0, z = 0;
+    bool primed = false;
+    
+    static int32_t step( const int32_t & state, const int16_t & input ){
+        return state + ( ( static_cast< int32_t >( input ) * 256 ) - state ) / ( 1 << shift );
+    }
+    
+    static int16_t whole( const int32_t & state ){
+        return static_cast< int16_t >( ( state + ( state < 0 ? -128 : 128 ) ) / 256 );
+    }
+
+public:
+
+    void add( const ADXL345::sample & s ){
+        if( !primed ){
+            x = s.x * 256;
+            y = s.y * 256;
+            z = s.z * 256;
+            primed = true;
+        } else {
+            x = step( x, s.x );
+            y = step( y, s.y );
+            z = step( z, s.z );
+        }
+    }
+    
+    ADXL345::sample value() const {
+        return ADXL345::sample{ whole( x ), whole( y ), whole( z ) };
+    }
+};
+
+/// \brief
+/// Median of the last N samples, per axis.
+/// \details
+/// Example: median_filter< 5 > spikes;
+///
+/// A single bad read can't move the median, unlike an average, so this is the one to put first when reads can spike.
+/// value() sorts a copy of the history per axis, so keep N small.
+template< size_t N >
+class median_filter {
+private:
+    static_assert( N % 2 == 1, "the median of an odd amount of samples is a sample" );
+
+    std::array< ADXL345::sample, N > history = {};
+    size_t next = 0;
+    size_t count = 0;
+    
+    template< typename Axis >
+    int16_t median( Axis axis ) const {
+        std::array< int16_t, N > values;
+        for( size_t i = 0; i < count; i++ ){
+            int16_t v = axis( history[ i ] );
+            size_t j = i;
+            for( ; j > 0 && values[ j - 1 ] > v; j-- ){
+                values[ j ] = values[ j - 1 ];
+            }
+            values[ j ] = v;
+        }
+        return values[ count / 2 ];
+    }
+
+public:
+
+    void add( const ADXL345::sample & s ){
+        history[ next ] = s;
+        next = ( next + 1 ) % N;
+        if( count < N ){
+            count++;
+        }
+    }
+    
+    ADXL345::sample value() const {
+        if( count == 0 ){
+            return ADXL345::sample{ 0, 0, 0 };
+        }
+        return ADXL345::sample{ 
+            median( []( const ADXL345::sample & s ){ return s.x; } ),
+            median( []( const ADXL345::sample & s ){ return s.y; } ),
+            median( []( const ADXL345::sample & s ){ return s.z; } )
+        };
+    }
+};
+
+#endif
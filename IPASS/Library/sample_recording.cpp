@@ -0,0 +1,190 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "sample_recording.hpp"
+
+static const uint8_t header[4] = {'I', 'P', 'R', 1};
+
+
+sample_recorder::sample_recorder(hwlib::ostream & out):
+    out(out)
+{
+    last_sample_us.fill(0);
+    last.fill({0, 0, 0});
+}
+
+
+void sample_recorder::put(const uint8_t & byte){
+    out.putc(static_cast<char>(byte));
+    written++;
+}
+
+
+void sample_recorder::put_unsigned(uint_fast64_t value){
+    while(value >= 0x80){
+        put((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    put(value);
+}
+
+
+// Zigzag puts the sign in the lowest bit, so small negative changes are as short as small positive ones.
+void sample_recorder::put_signed(const int32_t & value){
+    put_unsigned((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+
+void sample_recorder::put_head(const record_kind & kind, const uint8_t & index, const uint_fast64_t & time_us){
+    put((static_cast<uint8_t>(kind) << 4) | (index & 0x0F));
+    uint_fast64_t & last_time_us = (kind == record_kind::sample) ? last_sample_us[index] : last_event_us;
+    put_unsigned(time_us - last_time_us);
+    last_time_us = time_us;
+}
+
+
+void sample_recorder::start(){
+    written = 0;
+    last_sample_us.fill(0);
+    last_event_us = 0;
+    last.fill({0, 0, 0});
+    for(const auto & byte : header){
+        put(byte);
+    }
+}
+
+
+void sample_recorder::sample(const uint8_t & sensor, const uint_fast64_t & time_us, const ADXL345::sample & value){
+    if(sensor >= max_sensors){
+        return;
+    }
+    put_head(record_kind::sample, sensor, time_us);
+    put_signed(value.x - last[sensor].x);
+    put_signed(value.y - last[sensor].y);
+    put_signed(value.z - last[sensor].z);
+    last[sensor] = value;
+}
+
+
+void sample_recorder::button(const uint8_t & number, const uint_fast64_t & time_us){
+    put_head(record_kind::button, number, time_us);
+}
+
+
+void sample_recorder::gesture(const uint8_t & sensor, const gesture_event & event){
+    put_head(record_kind::gesture, sensor, event.time_us);
+    put(event.type);
+    put(event.axes);
+}
+
+
+uint32_t sample_recorder::bytes() const {
+    return written;
+}
+
+
+sample_player::sample_player(const uint8_t data[], const size_t & size):
+    data(data),
+    size(size)
+{
+    for(size_t i = 0; i + sizeof(header) <= size; i++){
+        size_t matched = 0;
+        while((matched < sizeof(header)) && (data[i + matched] == header[matched])){
+            matched++;
+        }
+        if(matched == sizeof(header)){
+            found = true;
+            start = i + sizeof(header);
+            break;
+        }
+    }
+    rewind();
+}
+
+
+bool sample_player::get(uint8_t & byte){
+    if(position >= size){
+        return false;
+    }
+    byte = data[position++];
+    return true;
+}
+
+
+bool sample_player::get_unsigned(uint_fast64_t & value){
+    value = 0;
+    uint8_t byte;
+    for(uint8_t shift = 0; shift < 64; shift += 7){
+        if(!get(byte)){
+            return false;
+        }
+        value |= static_cast<uint_fast64_t>(byte & 0x7F) << shift;
+        if(!(byte & 0x80)){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool sample_player::get_signed(int32_t & value){
+    uint_fast64_t zigzag;
+    if(!get_unsigned(zigzag)){
+        return false;
+    }
+    uint32_t bits = zigzag;
+    value = static_cast<int32_t>(bits >> 1) ^ -static_cast<int32_t>(bits & 1);
+    return true;
+}
+
+
+bool sample_player::valid() const {
+    return found;
+}
+
+
+bool sample_player::next(sample_record & record){
+    uint8_t tag;
+    uint_fast64_t delta;
+    if(!found || !get(tag) || !get_unsigned(delta)){
+        return false;
+    }
+    record = sample_record();
+    record.kind = static_cast<record_kind>(tag >> 4);
+    record.index = tag & 0x0F;
+    if((record.kind == record_kind::sample) && (record.index >= last.size())){
+        return false;
+    }
+    uint_fast64_t & last_time_us = (record.kind == record_kind::sample) ? last_sample_us[record.index] : last_event_us;
+    record.time_us = last_time_us + delta;
+    
+    if(record.kind == record_kind::sample){
+        int32_t x, y, z;
+        if(!get_signed(x) || !get_signed(y) || !get_signed(z)){
+            return false;
+        }
+        auto & previous = last[record.index];
+        previous.x += x;
+        previous.y += y;
+        previous.z += z;
+        record.value = previous;
+    } else if(record.kind == record_kind::gesture){
+        if(!get(record.type) || !get(record.axes)){
+            return false;
+        }
+    } else if(record.kind != record_kind::button){
+        return false;
+    }
+    last_time_us = record.time_us;
+    return true;
+}
+
+
+void sample_player::rewind(){
+    position = start;
+    last_sample_us.fill(0);
+    last_event_us = 0;
+    last.fill({0, 0, 0});
+}
@@ -0,0 +1,265 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SAMPLE_RECORDING_HPP
+#define SAMPLE_RECORDING_HPP
+
+/// @file
+
+#include <array>
+#include "hwlib.hpp"
+#include "ADXL345.hpp"
+#include "ADXL345_sampler.hpp"
+#include "ADXL345_gestures.hpp"
+#include "ring_buffer.hpp"
+
+/// \brief
+/// What a record in a recording holds.
+enum class record_kind : uint8_t {
+    sample = 0,
+    button = 1,
+    gesture = 2
+};
+
+/// \brief
+/// One record of a recording.
+/// \details
+/// index is the sensor for a sample or a gesture and the button number for a button.
+/// value is only used by samples, type (an ADXL345::interrupt bit) and axes only by gestures.
+struct sample_record {
+    record_kind kind = record_kind::sample;
+    uint_fast64_t time_us = 0;
+    uint8_t index = 0;
+    ADXL345::sample value = {0, 0, 0};
+    uint8_t type = 0;
+    uint8_t axes = 0;
+};
+
+/// \brief
+/// Writes timestamped samples, button presses and gestures to a stream in a compact binary format.
+/// \details
+/// Example: sample_recorder recorder(hwlib::cout);
+/// Example: recorder.start();
+/// Example: recorder.sample(0, s.time_us, s.value);
+///
+/// The recording starts with the 4 byte header "IPR" and version 1, after that every record is:
+///  - a tag byte with the record_kind in the high 4 bits and the index in the low 4 bits
+///  - the time in us since the previous sample of the same sensor, or for a button or gesture since the previous button or gesture, as a varint (7 bits per byte, the high bit means another byte follows)
+///  - for a sample the change of x, y and z since the previous sample of the same sensor as zigzag varints
+///  - for a gesture the type and axes bytes
+///
+/// A tilt changes slowly, so most samples at 100 Hz take 6 bytes instead of the 14 of a raw timestamp and sample.
+/// The bytes go out with putc, on the Due that is the serial port, so nothing else should be printed while recording.
+/// sample_player finds the header even when there was text before it.
+class sample_recorder {
+public:
+
+    /// The amount of sensors a recording can tell apart.
+    static constexpr size_t max_sensors = 4;
+
+private:
+    hwlib::ostream & out;
+    std::array< uint_fast64_t, max_sensors > last_sample_us;
+    uint_fast64_t last_event_us = 0;
+    std::array< ADXL345::sample, max_sensors > last;
+    uint32_t written = 0;
+    
+    void put(const uint8_t & byte);
+    void put_unsigned(uint_fast64_t value);
+    void put_signed(const int32_t & value);
+    void put_head(const record_kind & kind, const uint8_t & index, const uint_fast64_t & time_us);
+
+public:
+
+    /// \brief
+    /// Constructor for a sample_recorder that writes to out.
+    sample_recorder(hwlib::ostream & out);
+    
+    /// \brief
+    /// Writes the header and starts a new recording, the first record of every sensor and the first event have their time since 0.
+    void start();
+    
+    /// \brief
+    /// Records a sample of the given sensor, samples of sensors past max_sensors are ignored.
+    void sample(const uint8_t & sensor, const uint_fast64_t & time_us, const ADXL345::sample & value);
+    
+    /// \brief
+    /// Records a button press.
+    void button(const uint8_t & number, const uint_fast64_t & time_us);
+    
+    /// \brief
+    /// Records a gesture of the given sensor.
+    void gesture(const uint8_t & sensor, const gesture_event & event);
+    
+    /// \brief
+    /// Returns the amount of bytes written since start.
+    uint32_t bytes() const;
+};
+
+
+/// \brief
+/// Reads the records back from a recording in memory.
+/// \details
+/// Example: sample_player player(data, size);
+/// Example: sample_record record; while(player.next(record)){ ... }
+///
+/// Everything before the header is skipped, so a capture of the serial port can be used as it is.
+/// The times and samples come out exactly as they were recorded.
+/// Every sensor has its own time, so the samples of different sensors don't have to be recorded in time order.
+class sample_player {
+private:
+    const uint8_t * data;
+    size_t size;
+    size_t start = 0;
+    size_t position = 0;
+    bool found = false;
+    std::array< uint_fast64_t, sample_recorder::max_sensors > last_sample_us;
+    uint_fast64_t last_event_us = 0;
+    std::array< ADXL345::sample, sample_recorder::max_sensors > last;
+    
+    bool get(uint8_t & byte);
+    bool get_unsigned(uint_fast64_t & value);
+    bool get_signed(int32_t & value);
+
+public:
+
+    /// \brief
+    /// Constructor for a sample_player on size bytes of data, the data has to stay around while playing.
+    sample_player(const uint8_t data[], const size_t & size);
+    
+    /// \brief
+    /// Returns if the header was found.
+    bool valid() const;
+    
+    /// \brief
+    /// Reads the next record, returns false at the end of the data or at a record that is cut off or damaged.
+    bool next(sample_record & record);
+    
+    /// \brief
+    /// Goes back to the first record.
+    void rewind();
+};
+
+
+/// \brief
+/// An hwlib::ostream that keeps what is written in memory, for recording to something else than the serial port.
+/// \details
+/// Example: recording_buffer< 4096 > buffer; sample_recorder recorder(buffer);
+///
+/// Bytes that don't fit anymore are dropped.
+template< size_t N >
+class recording_buffer : public hwlib::ostream {
+private:
+    std::array< uint8_t, N > bytes;
+    size_t used = 0;
+
+public:
+    void putc(char c) override {
+        if(used < N){
+            bytes[used++] = static_cast<uint8_t>(c);
+        }
+    }
+    
+    void flush() override {}
+    
+    /// \brief
+    /// Returns the recorded bytes.
+    const uint8_t * data() const {
+        return bytes.data();
+    }
+    
+    /// \brief
+    /// Returns the amount of recorded bytes.
+    size_t size() const {
+        return used;
+    }
+    
+    /// \brief
+    /// Forgets what was recorded.
+    void clear(){
+        used = 0;
+    }
+};
+
+
+/// \brief
+/// A sample_source that plays a recording back as if it came from the sensors.
+/// \details
+/// Example: replay_source< 2 > replay(player, game_clock);
+/// Example: replay.drain(data);
+///
+/// The recording is played on the given clock, starting at the first drain: every drain gives the samples that were recorded up to the time that has passed since then.
+/// With a clock that only moves when the caller moves it a recording plays as fast as the host can go and gives the same result every run.
+/// A drain holds at most 33 samples per sensor like the FIFO, when a sensor has more the drain stops there and the rest comes with the next drain.
+/// time_us is then the time of the last sample that was played, so the times of the samples still work out.
+/// Buttons and gestures are kept until pop_event takes them, up to 16 at a time.
+template< size_t N >
+class replay_source : public sample_source< N > {
+private:
+    sample_player & player;
+    uint_fast64_t (*clock)();
+    ring_buffer< sample_record, 16 > events;
+    sample_record pending;
+    bool has_pending = false;
+    bool started = false;
+    bool done = false;
+    uint_fast64_t clock_start = 0;
+    uint_fast64_t record_start = 0;
+
+public:
+    using fifo_frame = typename sample_source< N >::fifo_frame;
+    
+    /// \brief
+    /// Constructor for a replay_source that plays player on clock.
+    replay_source(sample_player & player, uint_fast64_t (*clock)() = hwlib::now_us):
+        player(player),
+        clock(clock)
+    {}
+    
+    void drain(fifo_frame & result) override {
+        result.time_us = clock();
+        result.window_us = 0;
+        result.amounts.fill(0);
+        if(!started){
+            started = true;
+            clock_start = result.time_us;
+            has_pending = player.next(pending);
+            done = !has_pending;
+            record_start = pending.time_us;
+        }
+        uint_fast64_t until = record_start + (result.time_us - clock_start);
+        uint_fast64_t played_us = until;
+        while(has_pending && (pending.time_us <= until)){
+            if(pending.kind == record_kind::sample){
+                if(pending.index < N){
+                    if(result.amounts[pending.index] == 33){
+                        result.time_us = clock_start + (played_us - record_start);
+                        break;
+                    }
+                    result.samples[pending.index][result.amounts[pending.index]++] = pending.value;
+                    played_us = pending.time_us;
+                }
+            } else {
+                events.push(pending);
+            }
+            has_pending = player.next(pending);
+        }
+        done = !has_pending;
+    }
+    
+    /// \brief
+    /// Takes the oldest button or gesture record that has been played, returns false when there is none.
+    bool pop_event(sample_record & event){
+        return events.pop(event);
+    }
+    
+    /// \brief
+    /// Returns true once every record has been played.
+    bool finished() const {
+        return done;
+    }
+};
+
+#endif
@@ -0,0 +1,217 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ADXL345_model.hpp"
+#include "ADXL345.hpp"
+#include "registers.hpp"
+
+
+ADXL345_model::ADXL345_model(uint_fast64_t (*clock)()): clock(clock) {
+    for(auto & byte : registers){
+        byte = 0;
+    }
+    registers[DEVID] = 0xE5;
+    registers[BW_RATE] = 0x0A;
+}
+
+
+void ADXL345_model::set_acceleration(const int & x, const int & y, const int & z){
+    acceleration[0] = x;
+    acceleration[1] = y;
+    acceleration[2] = z;
+}
+
+
+bool ADXL345_model::is_writable(const uint8_t & register_address){
+    return ((register_address >= THRESH_TAP) && (register_address <= TAP_AXES))
+        || ((register_address >= BW_RATE) && (register_address <= INT_MAP))
+        || (register_address == DATA_FORMAT)
+        || (register_address == FIFO_CTL);
+}
+
+
+bool ADXL345_model::measuring(){
+    return power_ctl::measure.get(registers[POWER_CTL]);
+}
+
+
+uint8_t ADXL345_model::fifo_mode(){
+    return fifo_ctl::mode.get(registers[FIFO_CTL]);
+}
+
+
+void ADXL345_model::update(){
+    auto now = clock();
+    if(!measuring()){
+        return;
+    }
+    uint_fast64_t period = ADXL345::period_us(static_cast<ADXL345::data_rate>(bw_rate::rate.get(registers[BW_RATE])));
+    if(now > next_conversion + (64 * period)){
+        next_conversion = now - (33 * period);
+    }
+    while(next_conversion <= now){
+        convert();
+        last_conversion = next_conversion;
+        next_conversion += period;
+    }
+}
+
+
+void ADXL345_model::convert(){
+    uint8_t format = registers[DATA_FORMAT];
+    int range = data_format::range.get(format);
+    int bits = data_format::full_res.get(format) ? 10 + range : 10;
+    int32_t limit = 1 << (bits - 1);
+    int16_t data[3];
+    for(int i = 0; i < 3; i++){
+        int32_t offset_mg = (static_cast<int8_t>(registers[OFSX + i]) * 1000) / 64;
+        int32_t counts = ((acceleration[i] + offset_mg) * (1 << bits)) / (4000 << range);
+        if(counts >= limit){
+            counts = limit - 1;
+        } else if(counts < -limit){
+            counts = -limit;
+        }
+        if(data_format::justify.get(format)){
+            counts *= 1 << (16 - bits);
+        }
+        data[i] = counts;
+    }
+    
+    if(fifo_mode() == 0){
+        load_output(data);
+        registers[INT_SOURCE] |= ADXL345::data_ready;
+        return;
+    }
+    if(fifo_count == 32){
+        registers[INT_SOURCE] |= ADXL345::overrun;
+        if(fifo_mode() == 1){
+            return;
+        }
+        fifo_first = (fifo_first + 1) % 32;
+        fifo_count--;
+    }
+    uint8_t index = (fifo_first + fifo_count) % 32;
+    for(int i = 0; i < 3; i++){
+        fifo[index][i] = data[i];
+    }
+    fifo_count++;
+    if(fifo_count == 1){
+        load_output(fifo[fifo_first]);
+    }
+    registers[INT_SOURCE] |= ADXL345::data_ready;
+    if(fifo_count >= fifo_ctl::samples.get(registers[FIFO_CTL])){
+        registers[INT_SOURCE] |= ADXL345::watermark;
+    }
+}
+
+
+void ADXL345_model::load_output(const int16_t data[3]){
+    for(int i = 0; i < 3; i++){
+        registers[DATAX0 + (2 * i)] = data[i] & 0xFF;
+        registers[DATAX1 + (2 * i)] = (data[i] >> 8) & 0xFF;
+    }
+}
+
+
+void ADXL345_model::pop(){
+    registers[INT_SOURCE] &= ~ADXL345::overrun;
+    if(fifo_mode() == 0){
+        registers[INT_SOURCE] &= ~ADXL345::data_ready;
+        return;
+    }
+    if(fifo_count > 0){
+        fifo_first = (fifo_first + 1) % 32;
+        fifo_count--;
+        if(fifo_count > 0){
+            load_output(fifo[fifo_first]);
+        }
+    }
+    if(fifo_count == 0){
+        registers[INT_SOURCE] &= ~ADXL345::data_ready;
+    }
+    if(fifo_count < fifo_ctl::samples.get(registers[FIFO_CTL])){
+        registers[INT_SOURCE] &= ~ADXL345::watermark;
+    }
+}
+
+
+void ADXL345_model::register_written(const uint8_t & register_address, const uint8_t & old_byte){
+    if(register_address == POWER_CTL){
+        if(!power_ctl::measure.get(old_byte) && measuring()){
+            next_conversion = clock() + ADXL345::period_us(static_cast<ADXL345::data_rate>(bw_rate::rate.get(registers[BW_RATE])));
+        }
+    } else if(register_address == FIFO_CTL){
+        if(fifo_mode() == 0){
+            fifo_first = 0;
+            fifo_count = 0;
+            registers[INT_SOURCE] &= ~(ADXL345::watermark | ADXL345::overrun);
+        }
+    }
+}
+
+
+bool ADXL345_model::interrupt_pin(const bool & int2){
+    update();
+    uint8_t active = registers[INT_SOURCE] & registers[INT_ENABLE];
+    if(int2){
+        active &= registers[INT_MAP];
+    } else {
+        active &= ~registers[INT_MAP];
+    }
+    bool inverted = data_format::int_invert.get(registers[DATA_FORMAT]);
+    return (active != 0) != inverted;
+}
+
+
+uint_fast64_t ADXL345_model::last_conversion_us(){
+    update();
+    return last_conversion;
+}
+
+
+void ADXL345_model::write(const uint8_t data[], const size_t & n){
+    if(n == 0){
+        return;
+    }
+    update();
+    pointer = data[0];
+    for(size_t i = 1; i < n; i++){
+        if((pointer < sizeof(registers)) && is_writable(pointer)){
+            uint8_t old_byte = registers[pointer];
+            registers[pointer] = data[i];
+            register_written(pointer, old_byte);
+        }
+        pointer++;
+    }
+}
+
+
+void ADXL345_model::read(uint8_t data[], const size_t & n){
+    update();
+    bool read_data = false;
+    bool read_source = false;
+    for(size_t i = 0; i < n; i++){
+        if(pointer == FIFO_STATUS){
+            data[i] = fifo_count;
+        } else if(pointer < sizeof(registers)){
+            data[i] = registers[pointer];
+        } else {
+            data[i] = 0;
+        }
+        if((pointer >= DATAX0) && (pointer <= DATAZ1)){
+            read_data = true;
+        }
+        if(pointer == INT_SOURCE){
+            read_source = true;
+        }
+        pointer++;
+    }
+    if(read_source){
+        registers[INT_SOURCE] &= (ADXL345::data_ready | ADXL345::watermark | ADXL345::overrun);
+    }
+    if(read_data){
+        pop();
+    }
+}
@@ -0,0 +1,84 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef ADXL345_MODEL_HPP
+#define ADXL345_MODEL_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "i2c_bus_simulated.hpp"
+
+/// \brief
+/// Register model of an ADXL345 that can be attached to an i2c_bus_simulated.
+/// \details
+/// Example: ADXL345_model sensor;
+/// Example: sensor.set_acceleration(300, -200, 900);
+/// Example: bus.attach(0x53, sensor);
+///
+/// The model behaves like the sensor as far as the driver can see:
+///  - the register pointer auto-increments on multi-byte reads and writes
+///  - read only registers ignore writes
+///  - conversions only happen in measure mode (bit D3 of POWER_CTL), at the rate from BW_RATE
+///  - conversions use the offsets and DATA_FORMAT, including range, full resolution and justify
+///  - the FIFO works in bypass, FIFO and stream mode, trigger mode is handled like stream mode
+///  - reading the data registers pops the FIFO, data_ready, watermark and overrun are cleared by reading the data
+///  - reading INT_SOURCE clears the other interrupt bits
+///
+/// Conversions are worked out from the clock every time the model is accessed.
+/// The default clock is hwlib::now_us, a benchmark can give its own clock to get the same result every run.
+class ADXL345_model : public i2c_device_simulated {
+private:
+    uint8_t registers[0x3A];
+    uint8_t pointer = 0;
+    int16_t fifo[32][3];
+    uint8_t fifo_first = 0;
+    uint8_t fifo_count = 0;
+    int acceleration[3] = {0, 0, 1000};
+    uint_fast64_t (*clock)();
+    uint_fast64_t next_conversion = 0;
+    uint_fast64_t last_conversion = 0;
+    
+    bool is_writable(const uint8_t & register_address);
+    bool measuring();
+    uint8_t fifo_mode();
+    void update();
+    void convert();
+    void load_output(const int16_t data[3]);
+    void pop();
+    void register_written(const uint8_t & register_address, const uint8_t & old_byte);
+
+public:
+
+    /// \brief
+    /// Constructor for an ADXL345_model.
+    /// \details
+    /// The registers start with their power up values, so the model starts in standby mode at 100 Hz.
+    /// The acceleration starts at 1000 mg on the Z axis, like a sensor lying flat.
+    ADXL345_model(uint_fast64_t (*clock)() = hwlib::now_us);
+    
+    /// \brief
+    /// Sets the acceleration the model measures from the next conversion on, in milli-g.
+    void set_acceleration(const int & x, const int & y, const int & z);
+    
+    /// \brief
+    /// Returns the level of INT1, or of INT2 when int2 is true.
+    /// \details
+    /// A pin is asserted when an enabled interrupt that is mapped to it is set in INT_SOURCE.
+    /// INT_INVERT in DATA_FORMAT makes the pins active low, just like on the sensor.
+    bool interrupt_pin(const bool & int2 = false);
+    
+    /// \brief
+    /// Returns the clock time of the newest conversion, which is when the newest sample was taken.
+    /// \details
+    /// This is what a latency measurement on the Due can only estimate, so the simulator can measure from the real sample time.
+    uint_fast64_t last_conversion_us();
+    
+    void write(const uint8_t data[], const size_t & n) override;
+    
+    void read(uint8_t data[], const size_t & n) override;
+};
+
+#endif
@@ -0,0 +1,118 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "benchmark.hpp"
+#include "registers.hpp"
+
+static uint_fast64_t benchmark_time_us = 0;
+
+
+static uint_fast64_t benchmark_now_us(){
+    return benchmark_time_us;
+}
+
+
+// Prints total / count with 2 decimals since hwlib cannot print floats.
+static void print_per_sample(const uint64_t & total, const uint32_t & count){
+    uint64_t hundredths = (total * 100) / count;
+    hwlib::cout << "\t" << static_cast<uint32_t>(hundredths / 100) << ".";
+    if(hundredths % 100 < 10){
+        hwlib::cout << "0";
+    }
+    hwlib::cout << static_cast<uint32_t>(hundredths % 100);
+}
+
+
+benchmark::benchmark(const uint32_t & clock_hz, const bool & repeated_start):
+        bus(clock_hz, repeated_start),
+        sensor(benchmark_now_us),
+        sensor2(benchmark_now_us),
+        i2c_ipass_object(bus),
+        accelerometer(bus, 0x53, 0, 0, 0),
+        accelerometer2(bus, 0x1D, 0, 0, 0)
+    {
+        bus.attach(0x53, sensor);
+        bus.attach(0x1D, sensor2);
+    }
+
+
+void benchmark::print_row(const char * name, const uint32_t & samples){
+    hwlib::cout << name;
+    print_per_sample(bus.get_transactions(), samples);
+    print_per_sample(bus.get_bytes(), samples);
+    print_per_sample(bus.get_bus_time_ns() / 1000, samples);
+    hwlib::cout << hwlib::endl;
+    bus.reset_counters();
+}
+
+
+void benchmark::print_results(){
+    const uint32_t samples = 100;
+    accelerometer.setup(1);
+    accelerometer2.setup(1);
+    ADXL345_sampler< 2 > sensors({ &accelerometer, &accelerometer2 });
+    
+    hwlib::cout << hwlib::endl << "Benchmark per XYZ sample at " << bus.get_clock_hz() << " Hz" << hwlib::endl;
+    hwlib::cout << "read function   \ttransactions\tbytes\tbus us" << hwlib::endl;
+    
+    bus.reset_counters();
+    for(uint32_t i = 0; i < samples; i++){
+        benchmark_time_us += accelerometer.sample_period_us();
+        for(uint8_t address = DATAX0; address <= DATAZ1; address++){
+            i2c_ipass_object.read(address, 0x53);
+        }
+    }
+    print_row("read x6         ", samples);
+    
+    for(uint32_t i = 0; i < samples; i++){
+        benchmark_time_us += accelerometer.sample_period_us();
+        accelerometer.read_axis_2g(DATAX0, DATAX1);
+        accelerometer.read_axis_2g(DATAY0, DATAY1);
+        accelerometer.read_axis_2g(DATAZ0, DATAZ1);
+    }
+    print_row("read_axis_2g x3 ", samples);
+    
+    int axis_data[3];
+    for(uint32_t i = 0; i < samples; i++){
+        benchmark_time_us += accelerometer.sample_period_us();
+        accelerometer.read_all_axis_2g(axis_data);
+    }
+    print_row("read_all_axis_2g", samples);
+    
+    for(uint32_t i = 0; i < samples; i++){
+        benchmark_time_us += accelerometer.sample_period_us();
+        accelerometer.read_sample_mg();
+    }
+    print_row("read_sample_mg  ", samples);
+    
+    for(uint32_t i = 0; i < samples; i++){
+        benchmark_time_us += accelerometer.sample_period_us();
+        sensors.read();
+    }
+    print_row("sampler read x2 ", 2 * samples);
+    
+    accelerometer.set_fifo_mode(ADXL345::fifo_mode::stream, 16);
+    ADXL345::sample fifo_samples[32];
+    uint32_t drained = 0;
+    bus.reset_counters();
+    for(uint32_t i = 0; i < samples / 32 + 1; i++){
+        benchmark_time_us += 32 * accelerometer.sample_period_us();
+        drained += accelerometer.drain(fifo_samples, 32);
+    }
+    print_row("drain 32        ", drained);
+    
+    accelerometer2.set_fifo_mode(ADXL345::fifo_mode::stream, 16);
+    ADXL345_sampler< 2 >::fifo_frame fifo_data;
+    drained = 0;
+    bus.reset_counters();
+    for(uint32_t i = 0; i < samples / 32 + 1; i++){
+        benchmark_time_us += 32 * accelerometer.sample_period_us();
+        sensors.drain(fifo_data);
+        drained += fifo_data.amounts[0] + fifo_data.amounts[1];
+    }
+    print_row("sampler drain x2", drained);
+    accelerometer.set_fifo_mode(ADXL345::fifo_mode::bypass, 0);
+    accelerometer2.set_fifo_mode(ADXL345::fifo_mode::bypass, 0);
+}
@@ -0,0 +1,53 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "i2c_ipass.hpp"
+#include "ADXL345.hpp"
+#include "ADXL345_sampler.hpp"
+#include "i2c_bus_simulated.hpp"
+#include "ADXL345_model.hpp"
+
+/// \brief
+/// Measures what every ADXL345 read function costs on the bus.
+/// \details
+/// Example: benchmark bench;
+/// Example: bench.print_results();
+///
+/// The benchmark has its own simulated bus and sensor model, and the model runs on a clock that only moves when the benchmark moves it.
+/// That way every run gives exactly the same numbers, so they can be compared before and after a change to the driver.
+/// For every read function it prints the transactions, bytes and bus time in microseconds per sample, with 2 decimals.
+/// A second sensor is attached so the ADXL345_sampler can be measured with 2 sensors, its numbers are per sensor sample.
+class benchmark {
+private:
+    i2c_bus_simulated bus;
+    ADXL345_model sensor;
+    ADXL345_model sensor2;
+    i2c_ipass i2c_ipass_object;
+    ADXL345 accelerometer;
+    ADXL345 accelerometer2;
+    
+    void print_row(const char * name, const uint32_t & samples);
+
+public:
+
+    /// \brief
+    /// Constructor for a benchmark.
+    /// \details
+    /// The clock_hz is the clock of the simulated bus, the default is the 100 kHz standard mode.
+    /// repeated_start decides if a register read is one transaction or two, see i2c_bus_simulated.
+    benchmark(const uint32_t & clock_hz = 100000, const bool & repeated_start = false);
+    
+    /// \brief
+    /// Runs every read function and prints a row with its cost per sample.
+    void print_results();
+};
+
+#endif
@@ -0,0 +1,171 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <chrono>
+#include "game_benchmark.hpp"
+#include "ADXL345.hpp"
+#include "fixed.hpp"
+#include "ring_buffer.hpp"
+#include "sample_filters.hpp"
+#include "profiling.hpp"
+#include "ADXL345_model.hpp"
+#include "window_paged.hpp"
+#include "glcd_oled_paged.hpp"
+#include "drawable.hpp"
+#include "line.hpp"
+#include "cube.hpp"
+#include "moving_cube.hpp"
+#include "player.hpp"
+#include "hud.hpp"
+#include "entity_store.hpp"
+#include "pong.hpp"
+
+static uint_fast64_t game_time_us = 0;
+
+
+static uint_fast64_t game_now_us(){
+    return game_time_us;
+}
+
+
+// The host time in ns, a frame of the game takes only a few us on the host so hwlib::now_us is too coarse.
+static uint64_t host_ns(){
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// The tilt a player gives its sensor to get the paddle to the ball: gain mg per pixel that the ball is below the middle of the paddle, up to 750 mg.
+static int script_tilt(const pong & game, const size_t & paddle, const int & gain){
+    const player & p = game.get_paddle(paddle);
+    int ball_y = game.get_ball().get_location().y + 1;
+    int paddle_y = p.get_location().y + 6;
+    int tilt = (ball_y - paddle_y) * gain;
+    return std::min(std::max(tilt, -750), 750);
+}
+
+
+// Drains the FIFO of one sensor when it has reached its watermark and gives the samples to the paddle, with the time the model took each.
+static void drain_sensor(pong & game, const size_t & paddle, ADXL345 & accelerometer, ADXL345_model & sensor){
+    if(!(accelerometer.read_interrupt_source() & ADXL345::watermark)){
+        return;
+    }
+    ADXL345::sample samples[32];
+    size_t amount = accelerometer.drain(samples, 32);
+    uint_fast64_t newest = sensor.last_conversion_us();
+    for(size_t i = 0; i < amount; i++){
+        timed_sample s;
+        s.time_us = newest - (amount - 1 - i) * accelerometer.sample_period_us();
+        s.value = samples[i];
+        game.add_sample(paddle, s);
+    }
+}
+
+
+game_benchmark::game_benchmark(const uint32_t & clock_hz):
+    clock_hz(clock_hz)
+{}
+
+
+game_benchmark::result game_benchmark::run(const uint32_t & frames){
+    result measured;
+    game_time_us = 0;
+    i2c_bus_simulated bus(clock_hz, true);
+    ADXL345_model sensor(game_now_us);
+    ADXL345_model sensor2(game_now_us);
+    i2c_checksum_simulated display;
+    bus.attach(0x53, sensor);
+    bus.attach(0x1D, sensor2);
+    bus.attach(0x3C, display);
+
+    ADXL345 accelerometer(bus, 0x53, 0, 0, 0);
+    ADXL345 accelerometer2(bus, 0x1D, 0, 0, 0);
+    for(auto & a : { &accelerometer, &accelerometer2 }){
+        a->begin_batch();
+        a->set_data_rate< ADXL345::data_rate::hz_100 >();
+        a->set_data_format< ADXL345::data_format< ADXL345::range::g4, true > >();
+        a->set_fifo_mode(ADXL345::fifo_mode::stream, 8);
+        a->set_measuring_mode();
+        a->apply_batch();
+    }
+
+    glcd_oled_paged oled(bus, 0x3c);
+    pong game(oled);
+    bus.reset_counters();
+    display.reset();
+
+    for(uint32_t frame = 0; frame < frames; frame++){
+        sensor.set_acceleration(0, script_tilt(game, 0, 60), 900);
+        sensor2.set_acceleration(0, script_tilt(game, 1, 15), 900);
+
+        uint64_t start = host_ns();
+        drain_sensor(game, 0, accelerometer, sensor);
+        drain_sensor(game, 1, accelerometer2, sensor2);
+        game.steer(0, accelerometer.to_milli_g(game.filtered(0).y));
+        game.steer(1, accelerometer2.to_milli_g(game.filtered(1).y));
+        uint64_t sensors_done = host_ns();
+
+        // One step per frame like the Due when it keeps up, the score screen is shown for 25 frames.
+        uint64_t moved = sensors_done;
+        if(!game.playing()){
+            game.resume(game_now_us());
+        } else {
+            game.play(1, game_now_us(), [&](){ moved = host_ns(); });
+            if(!game.playing()){
+                measured.points++;
+                if(game.get_state() == pong::game_state::won){
+                    measured.games++;
+                }
+            }
+        }
+        uint64_t collided = host_ns();
+
+        game.draw();
+        uint64_t drawn = host_ns();
+        oled.flush();
+        uint64_t flushed = host_ns();
+
+        measured.sensors_ns += sensors_done - start;
+        measured.move_ns += moved - sensors_done;
+        measured.collide_ns += collided - moved;
+        measured.draw_ns += drawn - collided;
+        measured.flush_ns += flushed - drawn;
+        measured.flushed_bytes += oled.get_flushed_bytes();
+        measured.max_flushed_bytes = std::max(measured.max_flushed_bytes, oled.get_flushed_bytes());
+        measured.bus_ns += bus.get_bus_time_ns();
+        measured.frames++;
+
+        // The bus time is spent on the simulated clock, then it waits for the next frame.
+        game_time_us += bus.get_bus_time_ns() / 1000;
+        bus.reset_counters();
+        game_time_us = std::max< uint_fast64_t >(game_time_us, (frame + 1) * 40000ULL);
+    }
+    measured.checksum = display.get_checksum();
+    return measured;
+}
+
+
+void game_benchmark::print_row(const char * name, const uint64_t & total_ns, const uint32_t & frames){
+    hwlib::cout << name << "\t" << static_cast<uint32_t>(total_ns / (frames > 0 ? frames : 1)) << hwlib::endl;
+}
+
+
+void game_benchmark::print_results(){
+    const uint32_t frames = 5000;
+    hwlib::cout << hwlib::endl << "Headless game of " << frames << " frames of 40 ms, bus at " << clock_hz << " Hz" << hwlib::endl;
+    for(int run_number = 1; run_number <= 2; run_number++){
+        auto r = run(frames);
+        if(run_number == 1){
+            hwlib::cout << "part of a frame\tns on the host" << hwlib::endl;
+            print_row("sensors      ", r.sensors_ns, r.frames);
+            print_row("move         ", r.move_ns, r.frames);
+            print_row("collide      ", r.collide_ns, r.frames);
+            print_row("draw         ", r.draw_ns, r.frames);
+            print_row("flush        ", r.flush_ns, r.frames);
+            hwlib::cout << "flushed bytes per frame " << static_cast<uint32_t>(r.flushed_bytes / r.frames) << ", max " << r.max_flushed_bytes
+                << ", bus time per frame " << static_cast<uint32_t>(r.bus_ns / r.frames / 1000) << " us" << hwlib::endl;
+        }
+        hwlib::cout << "run " << run_number << ": " << r.points << " points, " << r.games << " games won, checksum " << r.checksum << hwlib::endl;
+    }
+}
@@ -0,0 +1,98 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef GAME_BENCHMARK_HPP
+#define GAME_BENCHMARK_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "i2c_bus_simulated.hpp"
+
+/// \brief
+/// Device that stands in for the OLED on a simulated bus and keeps a checksum of every byte written to it.
+class i2c_checksum_simulated : public i2c_device_simulated {
+private:
+    uint32_t checksum = 0;
+
+public:
+    void write(const uint8_t data[], const size_t & n) override {
+        for(size_t i = 0; i < n; i++){
+            checksum = (checksum * 31) + data[i];
+        }
+    }
+
+    void read(uint8_t data[], const size_t & n) override {
+        for(size_t i = 0; i < n; i++){
+            data[i] = 0;
+        }
+    }
+
+    /// \brief
+    /// Returns the checksum of everything written since the last reset.
+    uint32_t get_checksum() const {
+        return checksum;
+    }
+
+    /// \brief
+    /// Starts the checksum over.
+    void reset(){
+        checksum = 0;
+    }
+};
+
+
+/// \brief
+/// Plays the game of the Due headless on the host and prints what every part of a frame costs.
+/// \details
+/// Example: game_benchmark bench;
+/// Example: bench.print_results();
+///
+/// The same pong class as main.cpp is played on a glcd_oled_paged on a simulated bus, with two ADXL345_model sensors as the paddles.
+/// The sensors are tilted by a script that follows the ball, the second paddle reacts weaker so points get scored and the score screen is drawn as well.
+/// The sensors and the bus run on a simulated clock that moves 40 ms per frame, the host time of reading the sensors, moving, colliding, drawing and flushing is measured per frame.
+/// Next to the host time the bytes flushed per frame and the simulated bus time per frame are printed, those are what the frame costs on the Due.
+/// The checksum of everything flushed to the display is printed as well, two runs have to give the same checksum.
+class game_benchmark {
+public:
+
+    /// \brief
+    /// What one run of the benchmark measured, the times are the sums over all frames.
+    struct result {
+        uint32_t frames = 0;
+        uint32_t points = 0;
+        uint32_t games = 0;
+        uint64_t sensors_ns = 0;
+        uint64_t move_ns = 0;
+        uint64_t collide_ns = 0;
+        uint64_t draw_ns = 0;
+        uint64_t flush_ns = 0;
+        uint64_t flushed_bytes = 0;
+        uint32_t max_flushed_bytes = 0;
+        uint64_t bus_ns = 0;
+        uint32_t checksum = 0;
+    };
+
+private:
+    uint32_t clock_hz;
+
+    void print_row(const char * name, const uint64_t & total_ns, const uint32_t & frames);
+
+public:
+
+    /// \brief
+    /// Constructor for a game_benchmark, the bus runs at clock_hz with repeated starts like i2c_backend_bit_banged.
+    game_benchmark(const uint32_t & clock_hz = 400000);
+
+    /// \brief
+    /// Plays the given amount of frames from a fresh game and sensors and returns what it measured.
+    result run(const uint32_t & frames);
+
+    /// \brief
+    /// Plays 5000 frames twice and prints the cost per frame of every part and the checksum of each run.
+    void print_results();
+};
+
+#endif
@@ -0,0 +1,278 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "game_tests.hpp"
+#include "profiling.hpp"
+#include "drawable.hpp"
+#include "line.hpp"
+#include "cube.hpp"
+#include "moving_cube.hpp"
+#include "player.hpp"
+#include "hud.hpp"
+#include "entity_store.hpp"
+#include "frame_scheduler.hpp"
+#include "glcd_oled_paged.hpp"
+#include "ADXL345.hpp"
+#include "ADXL345_model.hpp"
+
+
+// Plays the walls, the ball and the paddles of the game for the given amount of steps.
+// The paddles go up and down at 2.7 pixels per step, rhythm sets how many steps they keep going one way.
+bool game_tests::ball_stays_in_field(const fixed_xy & speed, const int & rhythm, const int & steps){
+    entity_store< std::array< line, 4 >, std::array< moving_cube, 1 >, std::array< player, 2 > > entities(
+        w.size,
+        {{
+            line( w, hwlib::xy(   0,  0 ), hwlib::xy( 127,  0 ), hwlib::xy(1,-1) ),
+            line( w, hwlib::xy( 127,  0 ), hwlib::xy( 127, 63 ), hwlib::xy(4,4) ),
+            line( w, hwlib::xy(   0, 63 ), hwlib::xy( 127, 63 ), hwlib::xy(1,-1) ),
+            line( w, hwlib::xy(   0,  0 ), hwlib::xy(   0, 63 ), hwlib::xy(3,3) )
+        }},
+        {{ moving_cube( w, hwlib::xy( 20, 27 ), 3, speed ) }},
+        {{
+            player( w, hwlib::xy(  10, 24 ), hwlib::xy(  10, 37 ), hwlib::xy(-1,1) ),
+            player( w, hwlib::xy( 117, 24 ), hwlib::xy( 117, 37 ), hwlib::xy(-1,1) )
+        }}
+    );
+    auto & ball = entities.dynamic< 0 >()[ 0 ];
+    int previous_x = ball.get_location().x;
+    for(int step = 0; step < steps; step++){
+        for(int i = 0; i < 2; i++){
+            bool down = (((step * (3 + i)) + rhythm) / (5 + (rhythm % 4))) % 2;
+            entities.dynamic< 1 >()[ i ].set_speed(fixed::from_fixed(down ? 700 : -700));
+        }
+        entities.step();
+        auto location = ball.get_location();
+        int moved_x = location.x - previous_x;
+        previous_x = location.x;
+        if(ball.take_point() != 0){
+            continue;
+        }
+        if(location.x < 0 || location.y < 0 || location.x + 6 > 127 || location.y + 6 > 63){
+            return false;
+        }
+        if(((location.x + 6 < 10) && (moved_x > 0)) || ((location.x > 117) && (moved_x < 0))){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool game_tests::test_time_of_impact(){
+    line wall( w, hwlib::xy( 25, 0 ), hwlib::xy( 25, 63 ), hwlib::xy(-1,1) );
+    line paddle( w, hwlib::xy( 30, 20 ), hwlib::xy( 30, 33 ), hwlib::xy(-1,1) );
+    
+    moving_cube slow( w, hwlib::xy( 20, 27 ), 3, fixed_xy( fixed( 9 ), fixed( 0 ) ) );
+    slow.begin_step();
+    slow.update();
+    bool result = slow.time_of_impact( wall ) == 56;
+    
+    moving_cube fast( w, hwlib::xy( 20, 27 ), 3, fixed_xy( fixed( 20 ), fixed( 0 ) ) );
+    fast.begin_step();
+    fast.update();
+    result &= fast.time_of_impact( paddle ) == 89;
+    
+    moving_cube away( w, hwlib::xy( 20, 27 ), 3, fixed_xy( fixed( -9 ), fixed( 0 ) ) );
+    away.begin_step();
+    away.update();
+    return result && away.time_of_impact( wall ) == -1;
+}
+
+
+bool game_tests::test_collision(){
+    bool result = ball_stays_in_field(fixed_xy( fixed( 9 ), fixed( 5 ) ), 0, 5000);
+    // Speeds from 1 to 11 pixels per step on both axes, each with its own rhythm of the paddles.
+    for(int i = 1; i < 200; i++){
+        fixed_xy speed( fixed::from_fixed( 256 + ((i * 67) % 2600) ), fixed::from_fixed( 128 + ((i * 41) % 2600) ) );
+        result &= ball_stays_in_field(speed, i, 2000);
+    }
+    return result;
+}
+
+
+bool game_tests::test_oled_flush(){
+    i2c_bus_simulated bus;
+    i2c_log_simulated display;
+    bus.attach(0x3C, display);
+    glcd_oled_paged oled(bus, 0x3c);
+    display.reset();
+    
+    oled.flush();
+    bool result = display.writes == 16 && display.bytes == 1088 && oled.get_flushed_bytes() == 1088;
+    
+    display.reset();
+    oled.flush();
+    result &= display.writes == 0 && oled.get_flushed_bytes() == 0;
+    
+    oled.write(hwlib::xy(5, 17));
+    oled.write(hwlib::xy(20, 22));
+    display.reset();
+    oled.flush();
+    const uint8_t range[] = {0x00, 0x21, 5, 20, 0x22, 2, 2};
+    for(size_t i = 0; i < sizeof(range); i++){
+        result &= display.last_commands[i] == range[i];
+    }
+    result &= display.writes == 2 && display.bytes == 7 + 17 && oled.get_flushed_bytes() == 24;
+    
+    oled.write(hwlib::xy(20, 22), hwlib::black);
+    display.reset();
+    oled.flush();
+    return result && display.writes == 2 && display.bytes == 7 + 2 && display.last_commands[2] == 20 && display.last_commands[3] == 20;
+}
+
+
+bool game_tests::test_fill_rect(){
+    window_paged_buffer< 16, 16 > small;
+    small.fill_rect(hwlib::xy(2, 3), hwlib::xy(4, 10));
+    bool result = true;
+    for(int x = 2; x <= 4; x++){
+        result &= small.page(0)[x] == 0xF8 && small.page(1)[x] == 0x07;
+    }
+    result &= small.page(0)[1] == 0 && small.page(0)[5] == 0 && small.page(1)[1] == 0 && small.page(1)[5] == 0;
+    
+    small.fill_rect(hwlib::xy(2, 4), hwlib::xy(2, 5), hwlib::black);
+    result &= small.page(0)[2] == 0xC8 && small.page(0)[3] == 0xF8;
+    
+    small.clear();
+    small.fill_rect(hwlib::xy(1, 1), hwlib::xy(-3, -3));
+    result &= small.page(0)[0] == 0x03 && small.page(0)[1] == 0x03 && small.page(0)[2] == 0;
+    
+    small.clear();
+    small.hline(0, 15, 15);
+    small.vline(8, 0, 15);
+    for(int x = 0; x < 16; x++){
+        result &= small.page(0)[x] == ((x == 8) ? 0xFF : 0x00);
+        result &= small.page(1)[x] == ((x == 8) ? 0xFF : 0x80);
+    }
+    return result;
+}
+
+
+static uint_fast64_t scheduler_time_us = 0;
+static uint_fast64_t scheduler_slept_us = 0;
+
+
+static uint_fast64_t scheduler_now_us(){
+    return scheduler_time_us;
+}
+
+
+// Sleeping moves the clock of the test, so the scheduler sees the exact time it asked for.
+static void scheduler_sleep_us(int_fast32_t n){
+    scheduler_slept_us += n;
+    scheduler_time_us += n;
+}
+
+
+bool game_tests::test_frame_scheduler(){
+    scheduler_time_us = 1000;
+    scheduler_slept_us = 0;
+    frame_scheduler scheduler(20000, 20000, 4, scheduler_now_us, scheduler_sleep_us);
+    scheduler.start();
+    bool result = scheduler.steps() == 0;
+    scheduler_time_us += 50000;
+    result &= scheduler.steps() == 2;
+    scheduler_time_us += 10000;
+    result &= scheduler.steps() == 1;
+    scheduler_time_us += 140000;
+    result &= scheduler.steps() == 4 && scheduler.get_dropped_steps() == 3;
+    
+    scheduler.reset_statistics();
+    scheduler.start();
+    scheduler_time_us += 5000;
+    scheduler.wait();
+    result &= scheduler_slept_us == 15000 && scheduler.get_overruns() == 0 && scheduler.get_last_frame_us() == 5000;
+    scheduler_time_us += 30000;
+    scheduler.wait();
+    return result && scheduler_slept_us == 15000 && scheduler.get_overruns() == 1 && scheduler.get_frames() == 2 && scheduler.get_max_frame_us() == 30000;
+}
+
+
+// Compares the page of the window that the hud draws in with a copy of it.
+static bool same_page(const window_paged & w, const uint8_t copy[]){
+    for(int x = 0; x < w.size.x; x++){
+        if(w.page(3)[x] != copy[x]){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool game_tests::test_hud(){
+    hud score_board(w, hwlib::xy(20, 24));
+    w.clear();
+    score_board.draw();
+    uint8_t zero[128];
+    bool lit = false;
+    for(int x = 0; x < 128; x++){
+        zero[x] = w.page(3)[x];
+        lit |= zero[x] != 0;
+    }
+    w.clear();
+    score_board.draw();
+    bool result = lit && same_page(w, zero) && score_board.get_renders() == 1;
+    
+    result &= !score_board.add_point(1);
+    w.clear();
+    score_board.draw();
+    result &= !same_page(w, zero) && score_board.get_renders() == 2;
+    
+    result &= !score_board.add_point(1) && !score_board.add_point(2) && !score_board.add_point(1) && score_board.add_point(1);
+    score_board.reset();
+    w.clear();
+    score_board.draw();
+    return result && same_page(w, zero) && score_board.get_renders() == 3;
+}
+
+
+bool game_tests::test_i2c_counters(){
+    i2c_bus_simulated bus(400000, false);
+    ADXL345_model sensor;
+    i2c_log_simulated display;
+    bus.attach(0x53, sensor);
+    bus.attach(0x3C, display);
+    profiling::reset();
+    
+    ADXL345 accelerometer(bus, 0x53, 0, 0, 0);
+    accelerometer.begin_batch();
+    accelerometer.set_data_rate< ADXL345::data_rate::hz_100 >();
+    accelerometer.set_fifo_mode(ADXL345::fifo_mode::stream, 8);
+    accelerometer.set_measuring_mode();
+    accelerometer.apply_batch();
+    bool result = accelerometer.read_register(POWER_CTL) != 0xFF;
+    accelerometer.read_interrupt_source();
+    ADXL345::sample samples[32];
+    accelerometer.drain(samples, 32);
+    
+    glcd_oled_paged oled(bus, 0x3c);
+    oled.write(hwlib::xy(5, 17));
+    oled.flush();
+#ifndef IPASS_NO_PROFILING
+    result &= profiling::statistics().i2c_transactions == bus.get_calls() && profiling::statistics().i2c_bytes == bus.get_handed_bytes();
+#endif
+    return result && bus.get_calls() > 0 && bus.get_transactions() > bus.get_calls();
+}
+
+
+bool game_tests::print_result(const char * name, const bool & result){
+    hwlib::cout << name << ": " << result << hwlib::endl;
+    return result;
+}
+
+
+bool game_tests::print_test_results(){
+    bool passed = true;
+    hwlib::cout << "Running game tests" << hwlib::endl;
+    passed &= print_result("Test time of impact", test_time_of_impact());
+    passed &= print_result("Test collision", test_collision());
+    passed &= print_result("Test OLED flush", test_oled_flush());
+    passed &= print_result("Test fill rect", test_fill_rect());
+    passed &= print_result("Test frame scheduler", test_frame_scheduler());
+    passed &= print_result("Test hud", test_hud());
+    passed &= print_result("Test i2c counters", test_i2c_counters());
+    hwlib::cout << "Finished running game tests" << hwlib::endl;
+    return passed;
+}
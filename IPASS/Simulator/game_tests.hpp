@@ -0,0 +1,126 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef GAME_TESTS_HPP
+#define GAME_TESTS_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "fixed.hpp"
+#include "window_paged.hpp"
+#include "i2c_bus_simulated.hpp"
+
+/// \brief
+/// Device that stands in for the OLED on a simulated bus and remembers what was written to it.
+/// \details
+/// It counts the write transactions and their bytes, and keeps the last transaction that started with a 0x00 command byte.
+class i2c_log_simulated : public i2c_device_simulated {
+public:
+    uint32_t writes = 0;
+    uint32_t bytes = 0;
+    uint8_t last_commands[8] = {};
+    
+    void write(const uint8_t data[], const size_t & n) override {
+        writes++;
+        bytes += n;
+        if((n > 0) && (data[0] == 0x00)){
+            for(size_t i = 0; i < sizeof(last_commands); i++){
+                last_commands[i] = (i < n) ? data[i] : 0;
+            }
+        }
+    }
+    
+    void read(uint8_t data[], const size_t & n) override {
+        for(size_t i = 0; i < n; i++){
+            data[i] = 0;
+        }
+    }
+    
+    /// \brief
+    /// Starts counting over.
+    void reset(){
+        writes = 0;
+        bytes = 0;
+    }
+};
+
+/// \brief
+/// Tests of the game code in the Application folder, they only run in the Simulator.
+/// \details
+/// Example: game_tests test_object;
+/// Example: bool passed = test_object.print_test_results();
+///
+/// The tests class runs on the Due at every boot and only needs the library, these need the drawables and the OLED driver.
+/// They draw in a window_paged_buffer and talk to a simulated bus, so no display is needed.
+class game_tests {
+private:
+    window_paged_buffer< 128, 64 > w;
+    
+    bool print_result(const char * name, const bool & result);
+    bool ball_stays_in_field(const fixed_xy & speed, const int & rhythm, const int & steps);
+
+public:
+    /// \brief
+    /// Tests the time of impact of a fast ball against a wall and a thin paddle.
+    /// \details
+    /// A ball of 6 pixels 2 pixels from a wall, moving 9 pixels per step, hits it after 2/9 of the step, which is 56 of 256.
+    /// Moving 20 pixels per step it can't jump over a paddle of 1 pixel 7 pixels away, it hits it after 89 of 256.
+    /// A ball that moves away from the wall doesn't hit it.
+    bool test_time_of_impact();
+    
+    /// \brief
+    /// Tests that the ball never leaves the field and never hits a paddle from behind.
+    /// \details
+    /// The ball is played for thousands of steps at 9,5 and for 2000 steps at 199 other speeds up to 11 pixels per step while the paddles move up and down.
+    /// After every step it has to be inside the walls, unless it just crossed a goal line and that step scored a point.
+    /// Once it is behind a paddle it has to keep moving to the goal line, a bounce there means it hit the paddle from behind.
+    bool test_collision();
+    
+    /// \brief
+    /// Tests that a flush of glcd_oled_paged only sends the columns that changed.
+    /// \details
+    /// The first flush sends all 8 pages: per page 7 command bytes and 129 data bytes, 1088 bytes in 16 transactions.
+    /// A flush without a change sends nothing.
+    /// After 2 pixels in page 2 at column 5 and 20 change only that page is sent, columns 5 up to 20: 7 + 17 bytes in 2 transactions.
+    /// Clearing one of them again sends only that column.
+    bool test_oled_flush();
+    
+    /// \brief
+    /// Tests fill_rect, hline and vline of window_paged on the page bytes they should change.
+    /// \details
+    /// A rectangle from 2,3 up to 4,10 sets bit 3 to 7 of page 0 and bit 0 to 2 of page 1 in column 2 to 4 and leaves column 1 and 5 alone.
+    /// A black rectangle clears only its own bits, a rectangle partly outside of the window is clipped and one with start and end swapped is the same.
+    /// hline and vline are rectangles of 1 pixel wide.
+    bool test_fill_rect();
+    
+    /// \brief
+    /// Tests the steps and the waiting of frame_scheduler on a clock that only moves when the test moves it.
+    /// \details
+    /// With steps of 20 ms no step is due right after start(), after 50 ms 2 steps are and the 10 ms left carries over to the next call.
+    /// After a slow frame of 140 ms more the 7 due steps are capped at 4 and 3 are counted as dropped.
+    /// wait() sleeps exactly until the end of a frame that finished early, a frame that took too long is counted as an overrun and doesn't sleep.
+    bool test_frame_scheduler();
+    
+    /// \brief
+    /// Tests that the hud only renders its text again when the score changed.
+    /// \details
+    /// Drawing the score twice has to give the same pixels with one render, which get_renders() of the hud shows.
+    /// A point changes the pixels and renders once more, a fourth point wins, and after reset() the pixels are those of 0 - 0 again.
+    bool test_hud();
+    
+    /// \brief
+    /// Tests that profiling counts the i2c traffic the same way as the simulated bus.
+    /// \details
+    /// An ADXL345 and a glcd_oled_paged talk to a bus without repeated starts, so every read of a register is split in 2 transactions on the wire.
+    /// After setting up the sensor, reading registers, draining its FIFO, the init of the OLED and a flush, profiling has to count as many transactions and bytes as the calls and handed bytes of the bus.
+    bool test_i2c_counters();
+    
+    /// \brief
+    /// Runs all the tests, prints the results and returns true when all of them passed.
+    bool print_test_results();
+};
+
+#endif
@@ -0,0 +1,138 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "i2c_bus_simulated.hpp"
+
+
+i2c_bus_simulated::i2c_bus_simulated(const uint32_t & clock_hz, const bool & repeated_start):
+        clock_hz(clock_hz),
+        repeated_start(repeated_start)
+    {}
+
+
+i2c_device_simulated * i2c_bus_simulated::find(const uint8_t & device_id){
+    for(size_t i = 0; i < device_count; i++){
+        if(addresses[i] == device_id){
+            return devices[i];
+        }
+    }
+    return nullptr;
+}
+
+
+void i2c_bus_simulated::count(const size_t & n, const size_t & extra_bits){
+    uint64_t bits = 1 + (9 * (n + 1)) + 1 + extra_bits;
+    transactions++;
+    bytes += n + 1;
+    bus_time_ns += (bits * 1000000000ULL) / clock_hz;
+}
+
+
+bool i2c_bus_simulated::attach(const uint8_t & device_id, i2c_device_simulated & device){
+    if((device_count == max_devices) || (find(device_id) != nullptr)){
+        return false;
+    }
+    addresses[device_count] = device_id;
+    devices[device_count] = &device;
+    device_count++;
+    return true;
+}
+
+
+void i2c_bus_simulated::transfer_write(const uint8_t & device_id, const uint8_t data[], const size_t & n){
+    count(n);
+    auto device = find(device_id);
+    if(device != nullptr){
+        device->write(data, n);
+    }
+}
+
+
+void i2c_bus_simulated::transfer_read(const uint8_t & device_id, uint8_t data[], const size_t & n){
+    count(n);
+    auto device = find(device_id);
+    if(device != nullptr){
+        device->read(data, n);
+    } else {
+        for(size_t i = 0; i < n; i++){
+            data[i] = 0xFF;
+        }
+    }
+}
+
+
+void i2c_bus_simulated::write(const uint8_t & device_id, const uint8_t data[], const size_t & n){
+    calls++;
+    handed_bytes += n;
+    transfer_write(device_id, data, n);
+}
+
+
+void i2c_bus_simulated::read(const uint8_t & device_id, uint8_t data[], const size_t & n){
+    calls++;
+    handed_bytes += n;
+    transfer_read(device_id, data, n);
+}
+
+
+void i2c_bus_simulated::write_read(const uint8_t & device_id, const uint8_t out[], const size_t & n_out, uint8_t in[], const size_t & n_in){
+    calls++;
+    handed_bytes += n_out + n_in;
+    if(!repeated_start){
+        transfer_write(device_id, out, n_out);
+        transfer_read(device_id, in, n_in);
+        return;
+    }
+    // one transaction: the repeated start and the second address byte come on top of the bytes
+    count(n_out + 1 + n_in, 1);
+    auto device = find(device_id);
+    if(device != nullptr){
+        device->write(out, n_out);
+        device->read(in, n_in);
+    } else {
+        for(size_t i = 0; i < n_in; i++){
+            in[i] = 0xFF;
+        }
+    }
+}
+
+
+uint32_t i2c_bus_simulated::get_clock_hz(){
+    return clock_hz;
+}
+
+
+uint32_t i2c_bus_simulated::get_transactions(){
+    return transactions;
+}
+
+
+uint32_t i2c_bus_simulated::get_bytes(){
+    return bytes;
+}
+
+
+uint32_t i2c_bus_simulated::get_calls(){
+    return calls;
+}
+
+
+uint32_t i2c_bus_simulated::get_handed_bytes(){
+    return handed_bytes;
+}
+
+
+uint64_t i2c_bus_simulated::get_bus_time_ns(){
+    return bus_time_ns;
+}
+
+
+void i2c_bus_simulated::reset_counters(){
+    transactions = 0;
+    bytes = 0;
+    bus_time_ns = 0;
+    calls = 0;
+    handed_bytes = 0;
+}
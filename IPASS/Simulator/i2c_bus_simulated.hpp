@@ -0,0 +1,121 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef I2C_BUS_SIMULATED_HPP
+#define I2C_BUS_SIMULATED_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "i2c_backend.hpp"
+
+/// \brief
+/// Interface for a device that can be attached to an i2c_bus_simulated.
+/// \details
+/// The device gets the data bytes of every transaction that is addressed to it, the address byte itself is handled by the bus.
+class i2c_device_simulated {
+public:
+
+    virtual ~i2c_device_simulated() = default;
+
+    /// \brief
+    /// Is called with the data bytes of a write transaction to this device.
+    virtual void write(const uint8_t data[], const size_t & n) = 0;
+    
+    /// \brief
+    /// Has to fill in the data bytes of a read transaction from this device.
+    virtual void read(uint8_t data[], const size_t & n) = 0;
+};
+
+
+/// \brief
+/// In-memory i2c_backend that can run i2c_ipass and ADXL345 on a build machine.
+/// \details
+/// Example: i2c_bus_simulated bus;
+/// Example: ADXL345_model sensor;
+/// Example: bus.attach(0x53, sensor);
+/// Example: ADXL345 accelerometer(bus, 0x53, 0, 0, 0);
+///
+/// Devices are attached at an address, transactions to an address without a device read 0xFF like a bus with only pull ups would.
+/// The bus counts every transaction and every byte that goes over the wire, including the address bytes.
+/// Next to that it counts like profiling does: every call to the backend and the bytes handed to it, so the two can be compared.
+/// It also adds up how long the transactions would take on a real bus with the given clock:
+/// a start bit, 9 bits for the address and for every byte (8 data bits and an ack) and a stop bit.
+class i2c_bus_simulated : public i2c_backend {
+private:
+    static constexpr size_t max_devices = 8;
+    
+    uint8_t addresses[max_devices];
+    i2c_device_simulated * devices[max_devices];
+    size_t device_count = 0;
+    uint32_t clock_hz;
+    bool repeated_start;
+    uint32_t transactions = 0;
+    uint32_t bytes = 0;
+    uint64_t bus_time_ns = 0;
+    uint32_t calls = 0;
+    uint32_t handed_bytes = 0;
+    
+    i2c_device_simulated * find(const uint8_t & device_id);
+    void count(const size_t & n, const size_t & extra_bits = 0);
+    void transfer_write(const uint8_t & device_id, const uint8_t data[], const size_t & n);
+    void transfer_read(const uint8_t & device_id, uint8_t data[], const size_t & n);
+
+public:
+
+    /// \brief
+    /// Constructor for a simulated bus.
+    /// \details
+    /// The clock is only used to work out the bus time, the default is the 100 kHz standard mode.
+    /// When repeated_start is true write_read is counted as one transaction, like on i2c_backend_bit_banged and i2c_backend_twi.
+    /// Otherwise it is a write followed by a read, like on i2c_backend_hwlib.
+    i2c_bus_simulated(const uint32_t & clock_hz = 100000, const bool & repeated_start = false);
+    
+    /// \brief
+    /// Attaches a device at the given address.
+    /// \details
+    /// Returns false when the address is already taken or when there is no more room for devices.
+    bool attach(const uint8_t & device_id, i2c_device_simulated & device);
+    
+    void write(const uint8_t & device_id, const uint8_t data[], const size_t & n) override;
+    
+    void read(const uint8_t & device_id, uint8_t data[], const size_t & n) override;
+    
+    void write_read(const uint8_t & device_id, const uint8_t out[], const size_t & n_out, uint8_t in[], const size_t & n_in) override;
+    
+    /// \brief
+    /// Returns the clock of the bus in Hz.
+    uint32_t get_clock_hz();
+    
+    /// \brief
+    /// Returns the amount of transactions since the last reset_counters.
+    uint32_t get_transactions();
+    
+    /// \brief
+    /// Returns the amount of bytes, address bytes included, since the last reset_counters.
+    uint32_t get_bytes();
+    
+    /// \brief
+    /// Returns the amount of calls to write, read and write_read since the last reset_counters.
+    /// \details
+    /// A write_read is one call, also when it is 2 transactions on the wire. This is what profiling counts as i2c_transactions.
+    uint32_t get_calls();
+    
+    /// \brief
+    /// Returns the amount of bytes handed to write, read and write_read since the last reset_counters, without the address bytes.
+    /// \details
+    /// This is what profiling counts as i2c_bytes.
+    uint32_t get_handed_bytes();
+    
+    /// \brief
+    /// Returns the time the transactions since the last reset_counters would take on a real bus in nanoseconds.
+    uint64_t get_bus_time_ns();
+    
+    /// \brief
+    /// Sets all counters back to 0.
+    void reset_counters();
+};
+
+#endif
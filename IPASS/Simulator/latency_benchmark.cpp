@@ -0,0 +1,111 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "latency_benchmark.hpp"
+
+static uint_fast64_t latency_time_ns = 0;
+
+
+// The sensor has its own oscillator, here it runs 0.5% slow so its samples drift through the frames like they do on the real hardware.
+static constexpr uint_fast64_t sensor_clock_permille = 995;
+
+
+static uint_fast64_t latency_now_us(){
+    return latency_time_ns / 1000;
+}
+
+
+static uint_fast64_t sensor_now_us(){
+    return (latency_time_ns * sensor_clock_permille) / 1000000;
+}
+
+
+latency_benchmark::latency_benchmark(const uint32_t & clock_hz):
+        bus(clock_hz, true),
+        sensor(sensor_now_us),
+        accelerometer(bus, 0x53, 0, 0, 0)
+    {
+        bus.attach(0x53, sensor);
+        bus.attach(0x3C, display);
+    }
+
+
+void latency_benchmark::spend_bus_time(){
+    latency_time_ns += bus.get_bus_time_ns();
+    bus.reset_counters();
+}
+
+
+latency_histogram latency_benchmark::run(const uint32_t & frame_us, const uint8_t & watermark, const size_t & flush_bytes){
+    latency_histogram latencies;
+    // Bypass first to empty the FIFO of the previous run.
+    accelerometer.set_fifo_mode(ADXL345::fifo_mode::bypass, 0);
+    accelerometer.set_data_rate< ADXL345::data_rate::hz_100 >();
+    accelerometer.set_fifo_mode(ADXL345::fifo_mode::stream, watermark);
+    accelerometer.set_measuring_mode();
+    spend_bus_time();
+    
+    ADXL345::sample samples[32];
+    const uint8_t page_commands[7] = {0x00, 0x21, 0, 127, 0x22, 0, 0};
+    uint8_t display_bytes[129] = {0x40};
+    latency_tracer< 64 > tracer;
+    uint_fast64_t sample_us = 0;
+    uint_fast64_t frame_start = latency_now_us();
+    const uint_fast64_t end = frame_start + 10000000;
+    while(frame_start < end){
+        if(accelerometer.read_interrupt_source() & ADXL345::watermark){
+            size_t amount = accelerometer.drain(samples, 32);
+            if(amount > 0){
+                uint_fast64_t newest = sensor.last_conversion_us();
+                for(size_t i = 0; i < amount; i++){
+                    uint_fast64_t taken = newest - (amount - 1 - i) * accelerometer.sample_period_us();
+                    tracer.stamp((taken * 1000) / sensor_clock_permille);
+                }
+                sample_us = (newest * 1000) / sensor_clock_permille;
+            }
+        }
+        spend_bus_time();
+        
+        // The paddle moves with the newest sample, then the frame is flushed like glcd_oled_paged::send_page does it:
+        // per page of up to 128 bytes a transaction with the 7 command bytes that set the range and one with the display data.
+        uint_fast64_t moved_us = sample_us;
+        for(size_t done = 0; done < flush_bytes; done += 128){
+            size_t length = (flush_bytes - done < 128) ? flush_bytes - done : 128;
+            bus.write(0x3C, page_commands, sizeof(page_commands));
+            bus.write(0x3C, display_bytes, length + 1);
+        }
+        spend_bus_time();
+        
+        tracer.shown(moved_us, latency_now_us(), latencies);
+        
+        frame_start += frame_us;
+        if(latency_now_us() < frame_start){
+            latency_time_ns = frame_start * 1000;
+        } else {
+            frame_start = latency_now_us();
+        }
+    }
+    accelerometer.set_fifo_mode(ADXL345::fifo_mode::bypass, 0);
+    accelerometer.set_standby_mode();
+    spend_bus_time();
+    return latencies;
+}
+
+
+void latency_benchmark::print_row(const char * name, const latency_histogram & latencies){
+    hwlib::cout << name << "\t" << latencies.count() << "\t" << latencies.min_us() << "\t" << latencies.mean_us()
+        << "\t" << latencies.percentile_us(99) << "\t" << latencies.max_us() << hwlib::endl;
+}
+
+
+void latency_benchmark::print_results(){
+    hwlib::cout << hwlib::endl << "Input to photon latency at " << bus.get_clock_hz() << " Hz, sensor at 100 Hz" << hwlib::endl;
+    hwlib::cout << "frame, watermark, flush    \tcount\tmin us\tmean us\tp99 us\tmax us" << hwlib::endl;
+    // The paddles are at both ends of the screen, so a page where both moved is flushed almost completely: about 3 pages of 128 bytes.
+    print_row("40 ms, 8, 384 bytes (game) ", run(40000, 8, 384));
+    print_row("40 ms, 8, 1024 bytes       ", run(40000, 8, 1024));
+    print_row("40 ms, 1, 384 bytes        ", run(40000, 1, 384));
+    print_row("20 ms, 1, 384 bytes        ", run(20000, 1, 384));
+}
@@ -0,0 +1,67 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef LATENCY_BENCHMARK_HPP
+#define LATENCY_BENCHMARK_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "ADXL345.hpp"
+#include "latency_histogram.hpp"
+#include "i2c_bus_simulated.hpp"
+#include "ADXL345_model.hpp"
+
+/// \brief
+/// Device that accepts every write and reads 0, it stands in for the OLED on a simulated bus.
+class i2c_sink_simulated : public i2c_device_simulated {
+public:
+    void write(const uint8_t[], const size_t &) override {}
+    
+    void read(uint8_t data[], const size_t & n) override {
+        for(size_t i = 0; i < n; i++){
+            data[i] = 0;
+        }
+    }
+};
+
+
+/// \brief
+/// Measures the latency from a sensor sample until the flush that shows it has finished, for a few game loop settings.
+/// \details
+/// Example: latency_benchmark bench;
+/// Example: bench.print_results();
+///
+/// The game loop of the Due is played for 10 simulated seconds per setting on a clock that only moves with the bus time and the waits between frames.
+/// Every frame drains the FIFO when it has reached its watermark, moves the paddle with the newest sample and flushes the given amount of display bytes, in pages of 128 like glcd_oled_paged.
+/// Every drained sample is traced with a latency_tracer, from the moment the sensor model took it, so time spent in the FIFO is counted as well.
+/// The sensor model runs on a clock that is 0.5% slow, otherwise the samples would always land at the same moment in a frame.
+/// Drawing and the physics take no time here, on the Due the profiling counters show how long they take.
+class latency_benchmark {
+private:
+    i2c_bus_simulated bus;
+    ADXL345_model sensor;
+    i2c_sink_simulated display;
+    ADXL345 accelerometer;
+    
+    void spend_bus_time();
+    void print_row(const char * name, const latency_histogram & latencies);
+
+public:
+
+    /// \brief
+    /// Constructor for a latency_benchmark, the bus runs at clock_hz with repeated starts like i2c_backend_bit_banged.
+    latency_benchmark(const uint32_t & clock_hz = 400000);
+    
+    /// \brief
+    /// Plays the game loop with the given frame time, FIFO watermark and flush size and returns the latencies.
+    latency_histogram run(const uint32_t & frame_us, const uint8_t & watermark, const size_t & flush_bytes);
+    
+    /// \brief
+    /// Runs the settings of the game and a few faster ones and prints a row with the latencies of each.
+    void print_results();
+};
+
+#endif
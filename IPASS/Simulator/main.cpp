@@ -0,0 +1,63 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "hwlib.hpp"
+#include "i2c_ipass.hpp"
+#include "ADXL345.hpp"
+#include "tests.hpp"
+#include "i2c_bus_simulated.hpp"
+#include "ADXL345_model.hpp"
+#include "benchmark.hpp"
+#include "latency_benchmark.hpp"
+#include "replay_benchmark.hpp"
+#include "game_benchmark.hpp"
+#include "game_tests.hpp"
+#include "profiling.hpp"
+
+int main( int argc, char * argv[] ){
+    i2c_bus_simulated bus;
+    ADXL345_model sensor;
+    sensor.set_acceleration(300, -200, 900);
+    bus.attach(0x53, sensor);
+    
+    i2c_ipass i2c_ipass_object(bus);
+    ADXL345 accelerometer(bus, 0x53, -5, 4, 8);
+    
+    tests test_object(i2c_ipass_object, accelerometer);
+    // The sensor model never moves, so the calibrate test can run here
+    bool passed = test_object.print_test_results(true);
+    
+    // The drawables and the display driver of the game only run here, the Due doesn't run these at boot
+    game_tests game_test_object;
+    passed &= game_test_object.print_test_results();
+    
+    // hwlib's bit banged bus, followed by i2c_backend_bit_banged and i2c_backend_twi in fast mode
+    profiling::reset();
+    benchmark bench_standard(100000, false);
+    bench_standard.print_results();
+    benchmark bench_fast(400000, true);
+    bench_fast.print_results();
+    
+    // The same counters the Due prints: calls to the backend and the bytes handed to it, so a write_read is 1 call and address bytes aren't counted.
+    // game_tests::test_i2c_counters checks that they match what the simulated bus counts the same way.
+    hwlib::cout << "\nProfiling counters of both benchmarks\n" << profiling::statistics() << hwlib::endl;
+    
+    // From the sensor sample to the end of the flush that shows it, the game itself runs at 40 ms frames with a watermark of 8
+    latency_benchmark bench_latency;
+    bench_latency.print_results();
+    
+    // A recording made on the Due with IPASS_RECORD can be given as the first argument, otherwise the sensor model is recorded
+    static replay_benchmark bench_replay;
+    if((argc > 1) && !bench_replay.load(argv[1])){
+        hwlib::cout << "\nCan't read a recording from " << argv[1] << hwlib::endl;
+    }
+    bench_replay.print_results();
+    
+    // The game loop of main.cpp without the Due, scripted paddles and the per frame cost of every part
+    game_benchmark bench_game;
+    bench_game.print_results();
+    
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdio>
+#include "replay_benchmark.hpp"
+#include "sample_filters.hpp"
+#include "i2c_bus_simulated.hpp"
+#include "ADXL345_model.hpp"
+
+static uint_fast64_t replay_time_us = 0;
+
+
+static uint_fast64_t replay_now_us(){
+    return replay_time_us;
+}
+
+
+bool replay_benchmark::load(const char * path){
+    std::FILE * file = std::fopen(path, "rb");
+    if(file == nullptr){
+        return false;
+    }
+    recording.clear();
+    int c;
+    while((c = std::fgetc(file)) != EOF){
+        recording.putc(static_cast<char>(c));
+    }
+    std::fclose(file);
+    return sample_player(recording.data(), recording.size()).valid();
+}
+
+
+// Tilts both sensors back and forth over +-600 mg in opposite directions, with a period of a few seconds like a player would.
+void replay_benchmark::record_model(){
+    i2c_bus_simulated bus(400000, true);
+    ADXL345_model sensor(replay_now_us);
+    ADXL345_model sensor2(replay_now_us);
+    bus.attach(0x53, sensor);
+    bus.attach(0x1D, sensor2);
+    ADXL345 accelerometer(bus, 0x53, 0, 0, 0);
+    ADXL345 accelerometer2(bus, 0x1D, 0, 0, 0);
+    ADXL345_sampler< 2 > sensors({ &accelerometer, &accelerometer2 });
+    for(auto sensor_object : { &accelerometer, &accelerometer2 }){
+        sensor_object->begin_batch();
+        sensor_object->set_data_format< ADXL345::data_format< ADXL345::range::g4, true > >();
+        sensor_object->set_fifo_mode(ADXL345::fifo_mode::stream, 8);
+        sensor_object->set_measuring_mode();
+        sensor_object->apply_batch();
+    }
+    
+    recording.clear();
+    sample_recorder recorder(recording);
+    recorder.start();
+    ADXL345_sampler< 2 >::fifo_frame data;
+    const uint32_t period_us = accelerometer.sample_period_us();
+    for(uint32_t frame = 0; frame < 1500; frame++){
+        int tilt = static_cast<int>((frame * 40) % 2400) - 1200;
+        tilt = (tilt < 0 ? -tilt : tilt) - 600;
+        sensor.set_acceleration(0, tilt, 800);
+        sensor2.set_acceleration(0, -tilt, 800);
+        replay_time_us += 40000;
+        sensors.drain(data);
+        for(size_t d = 0; d < 2; d++){
+            for(size_t i = 0; i < data.amounts[d]; i++){
+                recorder.sample(d, replay_time_us - (data.amounts[d] - 1 - i) * period_us, data.samples[d][i]);
+            }
+        }
+        if(frame % 250 == 0){
+            recorder.button(3, replay_time_us);
+        }
+    }
+}
+
+
+uint32_t replay_benchmark::play(uint32_t & samples, uint32_t & events, uint_fast64_t & played_us){
+    sample_player player(recording.data(), recording.size());
+    replay_source< 2 > replay(player, replay_now_us);
+    std::array< median_filter< 5 >, 2 > medians;
+    std::array< exponential_filter< 2 >, 2 > smooth;
+    replay_source< 2 >::fifo_frame data;
+    sample_record event;
+    uint32_t checksum = 0;
+    samples = 0;
+    events = 0;
+    const uint_fast64_t start = replay_time_us;
+    do {
+        replay.drain(data);
+        for(size_t d = 0; d < 2; d++){
+            for(size_t i = 0; i < data.amounts[d]; i++){
+                medians[d].add(data.samples[d][i]);
+                smooth[d].add(medians[d].value());
+                samples++;
+            }
+            checksum = (checksum * 31) + static_cast<uint16_t>(smooth[d].value().y);
+        }
+        while(replay.pop_event(event)){
+            events++;
+        }
+        replay_time_us += 40000;
+    } while(!replay.finished());
+    played_us = replay_time_us - start;
+    return checksum;
+}
+
+
+void replay_benchmark::print_results(){
+    if(recording.size() == 0){
+        record_model();
+    }
+    hwlib::cout << hwlib::endl << "Replay of " << recording.size() << " recorded bytes through the paddle filters" << hwlib::endl;
+    if(!sample_player(recording.data(), recording.size()).valid()){
+        hwlib::cout << "no recording found" << hwlib::endl;
+        return;
+    }
+    for(int run = 1; run <= 2; run++){
+        uint32_t samples, events;
+        uint_fast64_t played_us;
+        auto host_start = hwlib::now_us();
+        uint32_t checksum = play(samples, events, played_us);
+        auto host_us = hwlib::now_us() - host_start;
+        hwlib::cout << "run " << run << ": " << samples << " samples and " << events << " events, "
+            << static_cast<uint32_t>((recording.size() * 100) / (samples > 0 ? samples : 1)) << " bytes per 100 samples, "
+            << static_cast<uint32_t>(played_us / 1000) << " ms played in " << static_cast<uint32_t>(host_us) << " us, checksum " << checksum << hwlib::endl;
+    }
+}
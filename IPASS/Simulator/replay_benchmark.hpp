@@ -0,0 +1,48 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef REPLAY_BENCHMARK_HPP
+#define REPLAY_BENCHMARK_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+#include "sample_recording.hpp"
+
+/// \brief
+/// Plays a recording through the paddle filters as fast as the host can and prints how long that took.
+/// \details
+/// Example: replay_benchmark bench;
+/// Example: bench.load("capture.bin"); // optional, otherwise a recording of the sensor model is used
+/// Example: bench.print_results();
+///
+/// A recording comes from the Due compiled with IPASS_RECORD, the captured serial output can be loaded as it is.
+/// Without one a recording of 60 s of two ADXL345_model sensors being tilted back and forth is made first.
+/// The recording is played through a replay_source on a clock that jumps 40 ms per frame, like the game loop, and every sample goes through the same median and exponential filter as a paddle.
+/// The checksum of the filtered values is printed, so the effect of a filter change on identical input can be seen, and two runs have to give the same checksum.
+class replay_benchmark {
+public:
+
+    /// The largest recording that can be loaded or made.
+    static constexpr size_t max_bytes = 262144;
+
+private:
+    recording_buffer< max_bytes > recording;
+    
+    void record_model();
+    uint32_t play(uint32_t & samples, uint32_t & events, uint_fast64_t & played_us);
+
+public:
+
+    /// \brief
+    /// Loads a recording from a file, returns false when the file can't be read or has no recording in it.
+    bool load(const char * path);
+    
+    /// \brief
+    /// Plays the recording twice and prints its size, the speed of playing it and the checksum.
+    void print_results();
+};
+
+#endif
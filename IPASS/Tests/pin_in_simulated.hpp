@@ -0,0 +1,53 @@
+//          Copyright Dylan Griffioen.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef PIN_IN_SIMULATED_HPP
+#define PIN_IN_SIMULATED_HPP
+
+/// @file
+
+#include "hwlib.hpp"
+
+class pin_in_simulated : public hwlib::pin_in {
+private:
+    bool level;
+    int reads = 0;
+
+public:
+
+    /// \brief
+    /// Constructor for a simulated input pin.
+    /// \details
+    /// Example: pin_in_simulated int1(false);
+    ///
+    /// This pin isn't connected to anything, its level is whatever was last given to set.
+    /// It can be used in place of a hwlib::target::pin_in to test code that waits on a pin, like an interrupt pin of a sensor.
+    pin_in_simulated(const bool & level = false):
+        level(level)
+    {}
+    
+    /// \brief
+    /// Sets the level that read will return.
+    void set(const bool & new_level){
+        level = new_level;
+    }
+    
+    /// \brief
+    /// Returns the level that was last set and counts how often the pin was read.
+    bool read() override {
+        reads++;
+        return level;
+    }
+    
+    void refresh() override {}
+    
+    /// \brief
+    /// Returns how often read has been called.
+    int get_reads(){
+        return reads;
+    }
+};
+
+#endif
@@ -6,6 +6,24 @@
 
 #include "tests.hpp"
 
+static_assert(ADXL345::data_format< ADXL345::range::g2 >::convert(256) == milli_g(1000), "+-2g 10 bit is 3.9 mg per bit");
+static_assert(ADXL345::data_format< ADXL345::range::g16 >::convert(-32) == milli_g(-1000), "+-16g 10 bit is 31.2 mg per bit");
+static_assert(ADXL345::data_format< ADXL345::range::g8, true >::convert(256) == milli_g(1000), "full resolution is always 3.9 mg per bit");
+static_assert(ADXL345::data_format< ADXL345::range::g4, false, true >::convert(0x4000) == milli_g(2000), "left justified +-4g has 0.12 mg per bit");
+
+static_assert((fifo_ctl::mode(2) | fifo_ctl::samples(8)).value == 0x88, "stream mode with a watermark of 8 is 10001000");
+static_assert((fifo_ctl::mode(2) | fifo_ctl::samples(8)).mask == 0xDF, "the trigger bit isn't part of the mode and the samples");
+static_assert(fifo_ctl::samples(40).value == 8, "values are cut off at the width of their field");
+static_assert(fifo_status::entries.get(0xA1) == 33, "the trigger bit isn't part of the entries");
+static_assert(ADXL345::data_format< ADXL345::range::g16, true >::register_value == 0x0B, "full resolution +-16g is 00001011");
+static_assert(!decltype(DATAX0)::writable && decltype(FIFO_CTL)::writable, "the data registers can only be read");
+
+static_assert((fixed(3) / 2).raw() == 384, "1.5 is 384 / 256");
+static_assert((fixed(3) / 2).whole() == 2 && (fixed(5) / 4).whole() == 1, "whole rounds to the nearest pixel");
+static_assert((-(fixed(3) / 2)).whole() == -1, "negative halves round up as well");
+static_assert((fixed(3) / 2) * (fixed(5) / 2) == fixed(15) / 4, "1.5 * 2.5 is 3.75 without rounding");
+static_assert(fixed_xy(fixed(2), fixed(1)) * fixed::from_fixed(128) == fixed_xy(fixed(1), fixed(1) / 2), "half of a step");
+
 tests::tests(const i2c_ipass & i2c_ipass_object, const ADXL345 & ADXL345_object):
         i2c_ipass_object(i2c_ipass_object),
         ADXL345_object(ADXL345_object)
@@ -34,6 +52,34 @@ bool tests::test_i2c_ipass_write(){
 }
 
 
+bool tests::test_i2c_ipass_read_burst(){
+    i2c_ipass_object.write(OFSX, 0x53, 1);
+    i2c_ipass_object.write(OFSY, 0x53, 2);
+    i2c_ipass_object.write(OFSZ, 0x53, 3);
+    uint8_t read_data[3];
+    i2c_ipass_object.read(OFSX, 0x53, read_data, 3);
+    i2c_ipass_object.write(OFSX, 0x53, 0);
+    i2c_ipass_object.write(OFSY, 0x53, 0);
+    i2c_ipass_object.write(OFSZ, 0x53, 0);
+    if((read_data[0] == 1) && (read_data[1] == 2) && (read_data[2] == 3)){
+        return true;
+    }
+    return false;
+}
+
+
+bool tests::test_ADXL345_sampler_discover(){
+    ADXL345_sampler< 1 > sampler({ &ADXL345_object });
+    size_t found = sampler.discover();
+    std::array< uint8_t, 1 > ids = { 0 };
+    sampler.addresses(ids);
+    if((found == 1) && sampler.is_present(0) && (ids[0] == 0x53)){
+        return true;
+    }
+    return false;
+}
+
+
 bool tests::test_ADXL345_measuring() {
     int axis_data[3];
     ADXL345_object.read_all_axis_2g(axis_data);
@@ -52,24 +98,334 @@ bool tests::test_ADXL345_measuring() {
 }
 
 
+bool tests::test_ADXL345_fifo(){
+    ADXL345_object.set_fifo_mode(ADXL345::fifo_mode::stream, 16);
+    hwlib::wait_ms(500);
+    ADXL345::sample samples[33];
+    size_t amount = ADXL345_object.drain(samples, 33);
+    uint8_t left = ADXL345_object.fifo_entries();
+    ADXL345_object.set_fifo_mode(ADXL345::fifo_mode::bypass, 0);
+    if((amount >= 16) && (left < 2)){
+        return true;
+    }
+    return false;
+}
+
+
+bool tests::test_ADXL345_interrupt(){
+    pin_in_simulated int1(false);
+    uint8_t source_low = ADXL345_object.poll_interrupt(int1);
+    ADXL345_object.set_interrupts(ADXL345::data_ready);
+    hwlib::wait_ms(20);
+    int1.set(true);
+    uint8_t source_high = ADXL345_object.poll_interrupt(int1);
+    ADXL345_object.set_interrupts(0);
+    if((source_low == 0) && (source_high & ADXL345::data_ready) && (int1.get_reads() == 2)){
+        return true;
+    }
+    return false;
+}
+
+
 bool tests::test_ADXL345_set_standby_mode(){
-    i2c_ipass_object.write(POWER_CTL, 0x53, 12);
+    i2c_ipass_object.write(POWER_CTL, 0x53, (power_ctl::measure(1) | power_ctl::sleep(1)).value);
+    ADXL345_object.resync();
     ADXL345_object.set_standby_mode();
     int read_data = i2c_ipass_object.read(POWER_CTL, 0x53);
-    if(read_data == 4){
-        i2c_ipass_object.write(POWER_CTL, 0x53, 0);
+    i2c_ipass_object.write(POWER_CTL, 0x53, 0);
+    ADXL345_object.resync();
+    if(read_data == power_ctl::sleep(1).value){
+        return true;
+    }
+    return false;
+}
+
+
+bool tests::test_ADXL345_data_rate(){
+    ADXL345_object.set_data_rate< ADXL345::data_rate::hz_12_5, true >();
+    int read_data = i2c_ipass_object.read(BW_RATE, 0x53);
+    uint32_t period = ADXL345_object.sample_period_us();
+    ADXL345_object.set_data_rate< ADXL345::data_rate::hz_100 >();
+    if((read_data == 23) && (period == 80000) && (ADXL345_object.sample_period_us() == 10000)){
+        return true;
+    }
+    return false;
+}
+
+
+bool tests::test_ADXL345_data_format(){
+    ADXL345_object.set_data_format< ADXL345::data_format< ADXL345::range::g16, true > >();
+    int read_data = i2c_ipass_object.read(DATA_FORMAT, 0x53);
+    milli_g full_resolution = ADXL345_object.to_milli_g(256);
+    ADXL345_object.set_data_format< ADXL345::data_format< ADXL345::range::g16 > >();
+    milli_g ten_bit = ADXL345_object.to_milli_g(32);
+    ADXL345_object.set_data_format< ADXL345::data_format< ADXL345::range::g2 > >();
+    if((read_data == 11) && (full_resolution == milli_g(1000)) && (ten_bit == milli_g(1000))){
+        return true;
+    }
+    return false;
+}
+
+
+// Returns true when value is within margin of target.
+static bool close_to(const milli_g & value, const int & target, const int & margin){
+    return (value > milli_g(target - margin)) && (value < milli_g(target + margin));
+}
+
+
+bool tests::test_ADXL345_calibrate(){
+    ADXL345::offsets before = ADXL345_object.get_offsets();
+    ADXL345_object.set_measuring_mode();
+    auto start = hwlib::now_us();
+    ADXL345_object.calibrate(ADXL345::orientation::z_up);
+    auto duration = hwlib::now_us() - start;
+    bool format_back = ADXL345_object.read_register(DATA_FORMAT) == 0x00;
+    ADXL345_object.set_data_format< ADXL345::data_format< ADXL345::range::g2, true > >();
+    hwlib::wait_ms(20);
+    ADXL345::sample_mg data = ADXL345_object.read_sample_mg();
+    ADXL345_object.set_data_format< ADXL345::data_format< ADXL345::range::g2 > >();
+    ADXL345_object.set_offsets(before);
+    if(format_back && (duration < 250000) && close_to(data.x, 0, 31) && close_to(data.y, 0, 31) && close_to(data.z, 1000, 31)){
+        return true;
+    }
+    return false;
+}
+
+
+// The registers that set_tap_detection and set_activity_detection write.
+// Sets the tap and activity registers back to 0.
+// ADXL345 only writes registers given by their register_descriptor, so ADXL345_object.write_register(INT_SOURCE, 0) or update_register(DEVID, 0xFF, 1) doesn't compile.
+static void clear_tap_registers(ADXL345 & accelerometer){
+    accelerometer.write_register(THRESH_TAP, 0);
+    accelerometer.write_register(DUR, 0);
+    accelerometer.write_register(LATENT, 0);
+    accelerometer.write_register(WINDOW, 0);
+    accelerometer.write_register(THRESH_ACT, 0);
+    accelerometer.write_register(ACT_INACT_CTL, 0);
+    accelerometer.write_register(TAP_AXES, 0);
+}
+
+
+bool tests::test_ADXL345_tap_detection(){
+    profiling::reset();
+    ADXL345_object.set_tap_detection(ADXL345::tap_config());
+#ifdef IPASS_NO_PROFILING
+    bool one_burst = true;
+#else
+    bool one_burst = profiling::statistics().i2c_transactions == 2;
+#endif
+    ADXL345_object.set_activity_detection(milli_g(1500));
+    uint8_t tap[8];
+    i2c_ipass_object.read(THRESH_TAP, 0x53, tap, 1);
+    i2c_ipass_object.read(DUR, 0x53, tap + 1, 7);
+    uint8_t tap_axes = i2c_ipass_object.read(TAP_AXES, 0x53);
+    clear_tap_registers(ADXL345_object);
+    if(one_burst && (tap[0] == 48) && (tap[1] == 16) && (tap[2] == 16) && (tap[3] == 240) && (tap[4] == 24) && (tap[7] == 0xF0) && (tap_axes == 7)){
+        return true;
+    }
+    return false;
+}
+
+
+bool tests::test_ADXL345_batch(){
+    ADXL345_object.resync();
+    const uint8_t saved_fifo = ADXL345_object.read_register(FIFO_CTL);
+    ADXL345_object.begin_batch();
+    ADXL345_object.set_tap_detection(ADXL345::tap_config());
+    ADXL345_object.set_activity_detection(milli_g(1500));
+    ADXL345_object.set_fifo_mode(ADXL345::fifo_mode::stream, 8);
+    bool held_back = (i2c_ipass_object.read(THRESH_TAP, 0x53) == 0) && (i2c_ipass_object.read(FIFO_CTL, 0x53) == saved_fifo);
+    size_t bursts = ADXL345_object.apply_batch();
+    uint8_t tap[14];
+    i2c_ipass_object.read(THRESH_TAP, 0x53, tap, 14);
+    uint8_t fifo = i2c_ipass_object.read(FIFO_CTL, 0x53);
+    
+    ADXL345_object.begin_batch();
+    clear_tap_registers(ADXL345_object);
+    ADXL345_object.write_register(FIFO_CTL, saved_fifo);
+    ADXL345_object.apply_batch();
+    if(held_back && (bursts == 3) && (tap[0] == 48) && (tap[4] == 16) && (tap[7] == 24) && (tap[10] == 0xF0) && (tap[13] == 7) && (fifo == 0x88)){
         return true;
     }
-    i2c_ipass_object.write(POWER_CTL, 0x53, 0);
     return false;
 }
 
 
-void tests::print_test_results(){
+bool tests::test_gesture_queue(){
+    gesture_queue< 4 > gestures;
+    size_t added = gestures.handle(ADXL345_object, ADXL345::single_tap | ADXL345::double_tap | ADXL345::watermark);
+    gesture_event first, second, third;
+    bool popped = gestures.pop(first) && gestures.pop(second) && !gestures.pop(third);
+    if((added == 2) && popped && (first.type == ADXL345::single_tap) && (second.type == ADXL345::double_tap)){
+        return true;
+    }
+    return false;
+}
+
+
+bool tests::test_ring_buffer(){
+    ring_buffer< int, 4 > buffer;
+    bool result = buffer.push(1) && buffer.push(2) && buffer.push(3) && !buffer.push(4);
+    int item = 0;
+    result &= buffer.pop(item) && item == 1;
+    result &= buffer.pop(item) && item == 2;
+    result &= buffer.push(4) && buffer.push(5) && buffer.size() == 3;
+    int expected = 3;
+    size_t amount = buffer.pop_all([&](const int & i){
+        result &= (i == expected++);
+    });
+    return result && amount == 3 && buffer.empty() && !buffer.pop(item);
+}
+
+
+bool tests::test_sample_filters(){
+    moving_average< 4 > average;
+    exponential_filter< 1 > exponential;
+    median_filter< 5 > median;
+    const int16_t inputs[] = {100, 100, 1000, 100, 100};
+    for(const auto & y : inputs){
+        ADXL345::sample s = {0, y, 0};
+        average.add(s);
+        exponential.add(s);
+        median.add(s);
+    }
+    return average.value().y == 325 && exponential.value().y == 213 && median.value().y == 100;
+}
+
+
+bool tests::test_profiling(){
+#ifdef IPASS_NO_PROFILING
+    return true;
+#else
+    profiling::reset();
+    i2c_ipass_object.read(DEVID, 0x53);
+    uint8_t data[6];
+    i2c_ipass_object.read(DATAX0, 0x53, data, 6);
+    {
+        IPASS_PROFILE_SCOPE(profiling::section::draw);
+        hwlib::wait_us(1000);
+    }
+    auto counted = profiling::statistics();
+    auto & draw = counted.sections[static_cast<size_t>(profiling::section::draw)];
+    profiling::reset();
+    if((counted.i2c_transactions == 2) && (counted.i2c_bytes == 9) && (draw.calls == 1) && (draw.total_us >= 1000)){
+        return true;
+    }
+    return false;
+#endif
+}
+
+
+bool tests::test_latency_histogram(){
+    latency_histogram latencies;
+    for(int i = 0; i < 99; i++){
+        latencies.record(5000);
+    }
+    latencies.record(60000);
+    bool histogram = (latencies.count() == 100) && (latencies.min_us() == 5000) && (latencies.mean_us() == 5550)
+        && (latencies.percentile_us(99) == 6000) && (latencies.percentile_us(100) == 60000) && (latencies.bucket(5) == 99);
+    
+    latency_histogram traced;
+    latency_tracer< 4 > tracer;
+    tracer.stamp(1000);
+    tracer.stamp(2000);
+    tracer.stamp(3000);
+    tracer.shown(2000, 10000, traced);
+    bool first = (traced.count() == 2) && (traced.min_us() == 8000) && (traced.max_us() == 9000);
+    tracer.shown(3000, 10000, traced);
+    return histogram && first && (traced.count() == 3) && (traced.min_us() == 7000);
+}
+
+
+static uint_fast64_t replay_time_us = 0;
+
+
+static uint_fast64_t replay_now_us(){
+    return replay_time_us;
+}
+
+
+bool tests::test_sample_recording(){
+    recording_buffer< 128 > buffer;
+    buffer << "boot text\n";
+    sample_recorder recorder(buffer);
+    recorder.start();
+    const ADXL345::sample first = {-12, 250, 1020};
+    const ADXL345::sample second = {-10, 247, 1021};
+    const ADXL345::sample other = {300, -300, 0};
+    recorder.sample(0, 1000000, first);
+    uint32_t before = recorder.bytes();
+    recorder.sample(0, 1010000, second);
+    bool compact = (recorder.bytes() - before) == 6;
+    recorder.sample(1, 1010000, other);
+    gesture_event tap;
+    tap.time_us = 1015000;
+    tap.type = ADXL345::double_tap;
+    tap.axes = ADXL345::axis_z;
+    recorder.gesture(0, tap);
+    recorder.button(3, 1020000);
+    
+    sample_player player(buffer.data(), buffer.size());
+    sample_record r[6];
+    bool read = player.valid() && player.next(r[0]) && player.next(r[1]) && player.next(r[2]) && player.next(r[3]) && player.next(r[4]) && !player.next(r[5]);
+    bool samples = (r[0].time_us == 1000000) && (r[0].value.z == 1020) && (r[1].time_us == 1010000) && (r[1].value.x == -10) && (r[1].value.y == 247)
+        && (r[2].index == 1) && (r[2].value.y == -300);
+    bool events = (r[3].kind == record_kind::gesture) && (r[3].type == ADXL345::double_tap) && (r[3].axes == ADXL345::axis_z) && (r[3].time_us == 1015000)
+        && (r[4].kind == record_kind::button) && (r[4].index == 3) && (r[4].time_us == 1020000);
+    
+    // The first drain plays the sample at 0, the 39 after it don't fit in one drain and the 6 that are left come with the next one.
+    recording_buffer< 512 > burst;
+    sample_recorder burst_recorder(burst);
+    burst_recorder.start();
+    for(int i = 0; i < 40; i++){
+        burst_recorder.sample(0, i * 10000, {static_cast<int16_t>(i), 0, 0});
+    }
+    sample_player burst_player(burst.data(), burst.size());
+    replay_source< 1 > replay(burst_player, replay_now_us);
+    replay_source< 1 >::fifo_frame frame;
+    replay_time_us = 0;
+    replay.drain(frame);
+    replay_time_us = 1000000;
+    replay.drain(frame);
+    bool carried = (frame.amounts[0] == 33) && (frame.samples[0][0].x == 1) && (frame.samples[0][32].x == 33) && (frame.time_us == 330000) && !replay.finished();
+    replay.drain(frame);
+    carried &= (frame.amounts[0] == 6) && (frame.samples[0][0].x == 34) && (frame.samples[0][5].x == 39) && (frame.time_us == 1000000) && replay.finished();
+    return compact && read && samples && events && carried;
+}
+
+
+bool tests::print_result(const char * name, const bool & result){
+    hwlib::cout << name << ": " << result << hwlib::endl;
+    return result;
+}
+
+
+bool tests::print_test_results(const bool & with_calibration){
+    bool passed = true;
     hwlib::cout << "Running tests" << hwlib::endl;
-    hwlib::cout << "Test i2c_ipass read: " << test_i2c_ipass_read() << hwlib::endl;
-    hwlib::cout << "Test i2c_ipass write: " << test_i2c_ipass_write() << hwlib::endl;
-    hwlib::cout << "Test ADXL345 measuring: " << test_ADXL345_measuring() << hwlib::endl;
-    hwlib::cout << "Test ADXL345 set standby mode: " << test_ADXL345_set_standby_mode() << hwlib::endl;
+    passed &= print_result("Test i2c_ipass read", test_i2c_ipass_read());
+    passed &= print_result("Test i2c_ipass write", test_i2c_ipass_write());
+    passed &= print_result("Test i2c_ipass read burst", test_i2c_ipass_read_burst());
+    passed &= print_result("Test ADXL345 sampler discover", test_ADXL345_sampler_discover());
+    passed &= print_result("Test ADXL345 measuring", test_ADXL345_measuring());
+    passed &= print_result("Test ADXL345 fifo", test_ADXL345_fifo());
+    passed &= print_result("Test ADXL345 interrupt", test_ADXL345_interrupt());
+    passed &= print_result("Test ADXL345 set standby mode", test_ADXL345_set_standby_mode());
+    passed &= print_result("Test ADXL345 data rate", test_ADXL345_data_rate());
+    passed &= print_result("Test ADXL345 data format", test_ADXL345_data_format());
+    if(with_calibration){
+        passed &= print_result("Test ADXL345 calibrate", test_ADXL345_calibrate());
+    } else {
+        hwlib::cout << "Test ADXL345 calibrate: skipped" << hwlib::endl;
+    }
+    passed &= print_result("Test ADXL345 tap detection", test_ADXL345_tap_detection());
+    passed &= print_result("Test ADXL345 batch", test_ADXL345_batch());
+    passed &= print_result("Test gesture queue", test_gesture_queue());
+    passed &= print_result("Test ring buffer", test_ring_buffer());
+    passed &= print_result("Test sample filters", test_sample_filters());
+    passed &= print_result("Test profiling", test_profiling());
+    passed &= print_result("Test latency histogram", test_latency_histogram());
+    passed &= print_result("Test sample recording", test_sample_recording());
     hwlib::cout << "Finished running tests" << hwlib::endl;
+    return passed;
 }
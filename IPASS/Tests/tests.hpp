@@ -11,13 +11,24 @@
 
 #include "i2c_ipass.hpp"
 #include "ADXL345.hpp"
+#include "ADXL345_sampler.hpp"
 #include "registers.hpp"
+#include "pin_in_simulated.hpp"
+#include "ring_buffer.hpp"
+#include "sample_filters.hpp"
+#include "ADXL345_gestures.hpp"
+#include "profiling.hpp"
+#include "latency_histogram.hpp"
+#include "sample_recording.hpp"
+#include "fixed.hpp"
 
 class tests {
 private: 
     i2c_ipass i2c_ipass_object;
     ADXL345 ADXL345_object;
     
+    bool print_result(const char * name, const bool & result);
+    
 public:
     /// \brief
     /// Constructor for a tests object.
@@ -40,6 +51,20 @@ public:
     /// Daarna zetten we de byte weer op 0 om te voorkomen dat het ergens anders problemen veroorzaakt.
     bool test_i2c_ipass_write();
     
+    /// \brief
+    /// Tests the burst read function from the i2c_ipass class.
+    /// \details
+    /// The 3 offset registers are next to each other, so this test writes 1, 2 and 3 to them with the tested write function.
+    /// Then it reads all 3 back in one burst, which should return them in the same order.
+    /// Afterwards the registers are set back to 0.
+    bool test_i2c_ipass_read_burst();
+    
+    /// \brief
+    /// Tests if an ADXL345_sampler finds the sensor during discover.
+    /// \details
+    /// The sensor answers with 0xE5 in its DEVID register, so discover should find 1 sensor at address 0x53.
+    bool test_ADXL345_sampler_discover();
+    
     /// \brief
     /// Tests wether or not the sensor can start measuring
     /// \details
@@ -51,20 +76,135 @@ public:
     /// Do keep in mind that when the sensor is hold upright the X and Y axis are 0 so in order for this funciton to work the sensor needs to be at an angle.
     bool test_ADXL345_measuring();
     
+    /// \brief
+    /// Tests if the FIFO fills up in stream mode and if drain empties it.
+    /// \details
+    /// This test needs the sensor to be in measure mode, so it has to run after test_ADXL345_measuring.
+    /// It puts the FIFO in stream mode and waits 500 ms, at the default 100 Hz the FIFO is full by then.
+    /// Then drain should return at least the watermark amount of samples and leave the FIFO (almost) empty.
+    /// Afterwards the FIFO is put back in bypass mode.
+    bool test_ADXL345_fifo();
+    
+    /// \brief
+    /// Tests if poll_interrupt only reads the sensor when the interrupt pin is asserted.
+    /// \details
+    /// This test uses a pin_in_simulated instead of the real INT1 pin so it doesn't need the pin to be wired up.
+    /// With the pin low poll_interrupt has to return 0 without touching the bus.
+    /// Then data_ready is enabled on INT1 and the pin is set high, now poll_interrupt has to return the data_ready bit because the sensor is measuring.
+    /// Afterwards all interrupts are disabled again.
+    bool test_ADXL345_interrupt();
+    
     /// \brief
     /// Test if the set_standby_mode function can return the sensor to standby mode without touching the other bits in the register.
     /// \details
     /// So the set_stanby_mode function is designed to only clear bit D3 which is the measure mode bit.
     /// To test this we write 12 to the register which is 00001100.
+    /// That write goes around the shadow copy of the ADXL345 object so resync is called to pick it up.
     /// Then after we exectute the set_standby_mode function it should clear bit D3 leaving 00000100 which is 4.
-    /// Then it writes 0 to the POWER_CTL register to ensure we don't leave any unwanted bits in there.
+    /// Then it writes 0 to the POWER_CTL register to ensure we don't leave any unwanted bits in there, and calls resync again so the shadow copy knows.
     bool test_ADXL345_set_standby_mode();
     
+    /// \brief
+    /// Tests if set_data_rate writes the right byte to BW_RATE and if the sample period follows it.
+    /// \details
+    /// 12.5 Hz has rate code 0111 and low power is bit D4, so BW_RATE should read 00010111 which is 23.
+    /// The period at 12.5 Hz is 80000 us.
+    /// Afterwards the rate is put back to the default of 100 Hz.
+    bool test_ADXL345_data_rate();
+    
+    /// \brief
+    /// Tests if set_data_format writes the right byte to DATA_FORMAT and switches the milli-g conversion along with it.
+    /// \details
+    /// +-16g with full resolution is 00001011 which is 11, and at 3.9 mg per bit 256 is 1000 mg.
+    /// Without full resolution +-16g has 31.2 mg per bit so 32 is 1000 mg.
+    /// Afterwards the power up format of +-2g is put back.
+    bool test_ADXL345_data_format();
+    
+    /// \brief
+    /// Tests if calibrate measures offsets that bring a resting sensor to 0, 0 and 1000 mg.
+    /// \details
+    /// This test needs the sensor to lie flat with Z pointing up, it puts the sensor in measure mode itself.
+    /// That is why print_test_results only runs it when it is asked to.
+    /// After calibrate a sample is read at full resolution, every axis should be within 2 offset steps (31 mg) of what lying flat measures.
+    /// Calibrating should take less than 250 ms and the data format has to be put back afterwards.
+    /// Afterwards the offsets from before the test are written back.
+    bool test_ADXL345_calibrate();
+    
+    /// \brief
+    /// Tests if set_tap_detection and set_activity_detection turn their settings into the right register steps.
+    /// \details
+    /// The default tap_config is 3000 mg, 10 ms, 20 ms and 300 ms on all axis.
+    /// In register steps that is 48 (62.5 mg), 16 (625 us), 16 (1.25 ms) and 240 (1.25 ms), and TAP_AXES should be 00000111 which is 7.
+    /// Activity at 1500 mg is 24 steps, and ac coupled on all axis sets the top half of ACT_INACT_CTL to 11110000 which is 240.
+    /// set_tap_detection has to do that in 2 transactions, the burst from THRESH_TAP up to WINDOW and TAP_AXES, which the profiling counters show.
+    /// Afterwards all of those registers are set back to 0.
+    bool test_ADXL345_tap_detection();
+    
+    /// \brief
+    /// Tests if a batch of settings is written in as few bursts as possible and ends up in the sensor.
+    /// \details
+    /// The batch sets tap detection, activity detection and stream mode with a watermark of 8.
+    /// Nothing may reach the sensor before apply_batch.
+    /// After a resync every register value is known, so the changes from THRESH_TAP up to TAP_AXES only need 2 bursts: THRESH_TAP alone and DUR up to TAP_AXES.
+    /// The 3 offset registers in between are too big a gap, the 2 inactivity and the 2 free fall registers are not.
+    /// FIFO_CTL is the third burst. Afterwards the registers are set back to what they were.
+    bool test_ADXL345_batch();
+    
+    /// \brief
+    /// Tests if a gesture_queue turns an INT_SOURCE byte into events.
+    /// \details
+    /// The source given to handle has single_tap, double_tap and watermark set.
+    /// Watermark isn't a gesture, so there should be 2 events: single_tap first and then double_tap.
+    bool test_gesture_queue();
+    
+    /// \brief
+    /// Tests if the ring_buffer keeps its items in order, stops when full and wraps around.
+    /// \details
+    /// This test doesn't use the sensor.
+    /// A ring_buffer of 4 holds 3 items, so the 4th push has to fail.
+    /// After popping 2 and pushing 2 more the items wrap around the end of the array, pop_all should still hand them over oldest first.
+    bool test_ring_buffer();
+    
+    /// \brief
+    /// Tests the moving average, exponential and median filters with a spike in the input.
+    /// \details
+    /// This test doesn't use the sensor.
+    /// The Y axis gets 100, 100, 1000, 100, 100: the median of those is 100 and the average of the last 4 is 325.
+    /// The exponential filter with shift 1 starts at 100, goes halfway to 1000 (550) and then halfway back twice, ending at 213.
+    bool test_sample_filters();
+    
+    /// \brief
+    /// Tests if the profiling counters count i2c_ipass transactions and time scopes.
+    /// \details
+    /// A single register read is 1 transaction of 2 bytes (register address and data) and a 6 byte burst read is 1 transaction of 7 bytes.
+    /// A scope that waits 1 ms should be recorded once with at least 1000 us.
+    /// When profiling is compiled out with IPASS_NO_PROFILING there is nothing to test and it passes.
+    /// Afterwards the counters are reset.
+    bool test_profiling();
+    
+    /// \brief
+    /// Tests if a latency_histogram and a latency_tracer give the right numbers.
+    /// \details
+    /// 99 latencies of 5 ms and one of 60 ms give a min of 5000 us, a mean of 5550 us, a p99 of 6000 us (the edge of the 5 ms bucket) and a max of 60000 us.
+    /// A tracer with samples at 1, 2 and 3 ms that is shown up to 2 ms at 10 ms should record 9000 and 8000 us and keep the third sample.
+    bool test_latency_histogram();
+    
+    /// \brief
+    /// Tests if a recording plays back exactly what was recorded and stays small.
+    /// \details
+    /// Two samples of sensor 0 10 ms apart, a sample of sensor 1, a double tap and a press of button 3 are recorded after some text.
+    /// The player has to skip the text and give back the same times, samples and events.
+    /// The second sample of sensor 0 changes every axis by at most 3, so that record should be 6 bytes: a tag, 2 bytes of time and one byte per axis.
+    bool test_sample_recording();
+    
     /// \brief
     /// This function runs all tests and prints the results
     /// \details
     /// Example: tests_oject.print_test_results();
-    void print_test_results();
+    ///
+    /// It returns true when every test passed, so the host simulator can use it as its exit code.
+    /// test_ADXL345_calibrate only runs when with_calibration is true, it needs a sensor that lies flat and still and it changes the offsets while it runs.
+    bool print_test_results(const bool & with_calibration = false);
 };
 
 #endif